@@ -2,6 +2,8 @@
 #include "spatial/common.hpp"
 #include "spatial/core/geometry/geometry_factory.hpp"
 
+#include "duckdb/planner/operator/logical_get.hpp"
+
 namespace spatial {
 
 namespace core {
@@ -19,6 +21,18 @@ public:
 	static GeometryFunctionLocalState &ResetAndGet(CastParameters &parameters);
 };
 
+struct SpatialFilterPushdown {
+	// Collect a bounding box per filter that the geometries of all rows of a scan have to intersect.
+	// Only filters of the form <spatial predicate>(column, <constant geometry>) on the geometry column
+	// with the given (table function) column index are considered. The boxes of separate predicates can not be
+	// intersected into one box, as a geometry can intersect two disjoint boxes.
+	// Comparisons of st_xmin/st_xmax/st_ymin/st_ymax(column) with constants that bound the extent of the column are
+	// combined into a single box. If exact is set, filters that only compare bounding boxes (st_intersects_extent)
+	// are skipped, as the geometry itself does not have to intersect the box to pass them.
+	static void GetFilterBoxes(LogicalGet &get, const vector<unique_ptr<Expression>> &filters, idx_t column_idx,
+	                           bool exact, vector<BoundingBox> &result);
+};
+
 } // namespace core
 
 } // namespace spatial
\ No newline at end of file
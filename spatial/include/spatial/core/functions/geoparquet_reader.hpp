@@ -21,7 +21,7 @@
 #include "templated_column_reader.hpp"
 
 #include <spatial/core/geometry/geometry.hpp>
-#include <spatial/core/geometry/geometry_factory.hpp>
+#include <spatial/core/geometry/wkb_transcoder.hpp>
 #include <string>
 
 namespace spatial {
@@ -56,7 +56,22 @@ public:
 
 	void InitializeSchema();
 	void InitializeScan(duckdb::ParquetReaderScanState &state, vector<duckdb::idx_t> groups_to_read);
+
+	//! Returns false if no geometry in the given column of the row group can intersect all of the bounding boxes,
+	//! based on the extent in the "geo" metadata and the statistics of the bbox covering columns (if any)
+	bool RowGroupMayIntersect(idx_t row_group_idx, const string &column_name, const vector<BoundingBox> &boxes);
+
+	//! The primary geometry column declared in the "geo" metadata, empty if the file has none
+	string primary_column;
 private:
+	void InitializeGeoMetadata();
+
+	//! The extent of the primary geometry column
+	bool has_extent = false;
+	BoundingBox extent;
+	//! The leaf column indexes of the xmin, ymin, xmax and ymax bbox covering columns
+	vector<idx_t> covering_columns;
+
 	unique_ptr<ColumnReader> CreateReader();
 	unique_ptr<ColumnReader> CreateReaderRecursive(idx_t depth, idx_t max_define, idx_t max_repeat,
 	                                               idx_t &next_schema_idx, idx_t &next_file_idx);
@@ -72,7 +87,7 @@ public:
 	static string_t DictRead(ByteBuffer &dict, uint32_t &offset, ColumnReader &reader);
 	static string_t PlainRead(ByteBuffer &plain_data, ColumnReader &reader);
 	static void PlainSkip(ByteBuffer &plain_data, ColumnReader &reader);
-	static string_t ConvertToSerializedGeometry(char const* data, uint32_t length, spatial::core::GeometryFactory &factory, VectorStringBuffer& buffer);
+	static string_t ConvertToSerializedGeometry(char const* data, uint32_t length, VectorStringBuffer& buffer);
 };
 
 class WKBColumnReader : public TemplatedColumnReader<string_t, WKBParquetValueConversion> {
@@ -81,7 +96,6 @@ public:
 	explicit WKBColumnReader(ParquetReader &reader, LogicalType type_p, const SchemaElement &schema_p, idx_t schema_idx_p,
 	                         idx_t max_define_p, idx_t max_repeat_p);
 
-	GeometryFactory factory;
 	shared_ptr<VectorStringBuffer> buffer;
 
 public:
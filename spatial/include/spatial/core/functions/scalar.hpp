@@ -27,6 +27,7 @@ public:
 		RegisterStGeometryType(db);
 		RegisterStGeomFromHEXWKB(db);
 		RegisterStGeomFromWKB(db);
+		RegisterStHilbert(db);
 		RegisterStIntersects(db);
 		RegisterStIntersectsExtent(db);
 		RegisterStIsEmpty(db);
@@ -48,6 +49,7 @@ public:
 		RegisterStY(db);
 		RegisterStYMax(db);
 		RegisterStYMin(db);
+		RegisterStZOrder(db);
 	}
 
 private:
@@ -108,6 +110,9 @@ private:
 	// ST_GeomFromWKB
 	static void RegisterStGeomFromWKB(DatabaseInstance &db);
 
+	// ST_Hilbert
+	static void RegisterStHilbert(DatabaseInstance &db);
+
 	// ST_Intersects
 	static void RegisterStIntersects(DatabaseInstance &db);
 
@@ -170,6 +175,9 @@ private:
 
 	// ST_YMin
 	static void RegisterStYMin(DatabaseInstance &db);
+
+	// ST_ZOrder
+	static void RegisterStZOrder(DatabaseInstance &db);
 };
 
 } // namespace core
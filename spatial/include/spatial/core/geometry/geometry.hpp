@@ -90,6 +90,16 @@ struct BoundingBox {
 	bool Intersects(const BoundingBox &other) const {
 		return !(minx > other.maxx || maxx < other.minx || miny > other.maxy || maxy < other.miny);
 	}
+
+	// True if other lies within this box, boundary included
+	bool Contains(const BoundingBox &other) const {
+		return minx <= other.minx && miny <= other.miny && maxx >= other.maxx && maxy >= other.maxy;
+	}
+
+	// True if other lies strictly within the interior of this box
+	bool ContainsProperly(const BoundingBox &other) const {
+		return minx < other.minx && miny < other.miny && maxx > other.maxx && maxy > other.maxy;
+	}
 };
 
 struct Geometry;
@@ -51,6 +51,9 @@ public:
 	Geometry Deserialize(const string_t &data);
 
 	static bool TryGetSerializedBoundingBox(const string_t &data, BoundingBox &bbox);
+	// Returns true if the serialized geometry is a polygon without holes whose shell is an axis-aligned rectangle,
+	// in which case its exact (double precision) extent is written to bbox.
+	static bool TryGetSerializedRectangle(const string_t &data, BoundingBox &bbox);
 
 	// Deep Copy
 	VertexVector CopyVertexVector(const VertexVector &vector);
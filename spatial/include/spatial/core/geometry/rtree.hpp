@@ -0,0 +1,49 @@
+#pragma once
+#include "spatial/common.hpp"
+#include "spatial/core/geometry/geometry.hpp"
+
+namespace spatial {
+
+namespace core {
+
+//------------------------------------------------------------------------------
+// FlatRTree
+//------------------------------------------------------------------------------
+// A static, bulk-loaded R-tree over bounding boxes.
+//
+// The leaves are packed using the Sort-Tile-Recursive (STR) algorithm, the
+// upper levels are then packed bottom-up by grouping NODE_CAPACITY consecutive
+// nodes. Since all nodes (except the last one on each level) are full, the
+// tree can be stored as one flat array of boxes per level, where the children
+// of node i on level n are the nodes [i * NODE_CAPACITY, (i + 1) * NODE_CAPACITY)
+// on level n - 1. Level 0 contains the items themselves.
+//
+class FlatRTree {
+public:
+	static constexpr idx_t NODE_CAPACITY = 16;
+
+	// Bulk load the tree. The id of each item is its position in the input vector
+	explicit FlatRTree(vector<BoundingBox> boxes);
+
+	// Append the ids of all items whose bounding box intersects the query box to the result
+	void Search(const BoundingBox &query, vector<idx_t> &result) const;
+
+	idx_t Count() const {
+		return item_ids.size();
+	}
+
+	const BoundingBox &Bounds() const {
+		return bounds;
+	}
+
+private:
+	void SearchNode(const BoundingBox &query, idx_t level, idx_t node_idx, vector<idx_t> &result) const;
+
+	vector<vector<BoundingBox>> levels;
+	vector<idx_t> item_ids;
+	BoundingBox bounds;
+};
+
+} // namespace core
+
+} // namespace spatial
@@ -0,0 +1,100 @@
+#pragma once
+#include "spatial/common.hpp"
+#include "spatial/core/geometry/geometry.hpp"
+
+namespace spatial {
+
+namespace core {
+
+// Encodes positions along space filling curves over a 2^16 x 2^16 grid spanning a bounding box.
+// Sorting by these keys clusters spatially close geometries together.
+struct SpaceFillingCurve {
+	static constexpr uint32_t GRID_MAX = 0xFFFF;
+
+	// Map a coordinate onto the [0, GRID_MAX] grid cell range spanned by [min, max]
+	static inline uint32_t ToGrid(double value, double min, double max) {
+		if (!(max > min)) {
+			return 0;
+		}
+		auto scaled = (value - min) / (max - min) * GRID_MAX;
+		if (!(scaled > 0)) {
+			return 0;
+		}
+		if (scaled >= GRID_MAX) {
+			return GRID_MAX;
+		}
+		return static_cast<uint32_t>(scaled);
+	}
+
+	// Spread the lower 16 bits of x out over the even bits of the result
+	static inline uint32_t Interleave(uint32_t x) {
+		x = (x | (x << 8)) & 0x00FF00FF;
+		x = (x | (x << 4)) & 0x0F0F0F0F;
+		x = (x | (x << 2)) & 0x33333333;
+		x = (x | (x << 1)) & 0x55555555;
+		return x;
+	}
+
+	static inline uint32_t ZOrderEncode(uint32_t x, uint32_t y) {
+		return (Interleave(y) << 1) | Interleave(x);
+	}
+
+	// Branchless hilbert curve index of a 16-bit grid cell, based on the "prefix scan" formulation
+	// from http://threadlocalmutex.com/?p=126
+	static inline uint32_t HilbertEncode(uint32_t x, uint32_t y) {
+		uint32_t a = x ^ y;
+		uint32_t b = 0xFFFF ^ a;
+		uint32_t c = 0xFFFF ^ (x | y);
+		uint32_t d = x & (y ^ 0xFFFF);
+
+		uint32_t A = a | (b >> 1);
+		uint32_t B = (a >> 1) ^ a;
+		uint32_t C = ((c >> 1) ^ (b & (d >> 1))) ^ c;
+		uint32_t D = ((a & (c >> 1)) ^ (d >> 1)) ^ d;
+
+		a = A;
+		b = B;
+		c = C;
+		d = D;
+		A = ((a & (a >> 2)) ^ (b & (b >> 2)));
+		B = ((a & (b >> 2)) ^ (b & ((a ^ b) >> 2)));
+		C ^= ((a & (c >> 2)) ^ (b & (d >> 2)));
+		D ^= ((b & (c >> 2)) ^ ((a ^ b) & (d >> 2)));
+
+		a = A;
+		b = B;
+		c = C;
+		d = D;
+		A = ((a & (a >> 4)) ^ (b & (b >> 4)));
+		B = ((a & (b >> 4)) ^ (b & ((a ^ b) >> 4)));
+		C ^= ((a & (c >> 4)) ^ (b & (d >> 4)));
+		D ^= ((b & (c >> 4)) ^ ((a ^ b) & (d >> 4)));
+
+		a = A;
+		b = B;
+		c = C;
+		d = D;
+		C ^= ((a & (c >> 8)) ^ (b & (d >> 8)));
+		D ^= ((b & (c >> 8)) ^ ((a ^ b) & (d >> 8)));
+
+		a = C ^ (C >> 1);
+		b = D ^ (D >> 1);
+
+		uint32_t i0 = x ^ y;
+		uint32_t i1 = b | (0xFFFF ^ (i0 | a));
+
+		return (Interleave(i1) << 1) | Interleave(i0);
+	}
+
+	static inline uint32_t Hilbert(double x, double y, const BoundingBox &bounds) {
+		return HilbertEncode(ToGrid(x, bounds.minx, bounds.maxx), ToGrid(y, bounds.miny, bounds.maxy));
+	}
+
+	static inline uint32_t ZOrder(double x, double y, const BoundingBox &bounds) {
+		return ZOrderEncode(ToGrid(x, bounds.minx, bounds.maxx), ToGrid(y, bounds.miny, bounds.maxy));
+	}
+};
+
+} // namespace core
+
+} // namespace spatial
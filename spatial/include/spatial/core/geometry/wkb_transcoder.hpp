@@ -0,0 +1,60 @@
+#pragma once
+#include "spatial/common.hpp"
+#include "spatial/core/geometry/geometry.hpp"
+#include "spatial/core/geometry/wkb_reader.hpp"
+
+namespace spatial {
+
+namespace core {
+
+// Converts WKB directly into the serialized GEOMETRY format, without materializing a Geometry in between.
+// The input is first scanned to validate it and compute the serialized size (skipping over the coordinates),
+// after which the coordinates are copied into the result in a single pass while the bounding box is computed.
+// The transcoder holds no state between geometries, so it can be used freely across rows and chunks.
+struct WKBTranscoder {
+private:
+	const char *data;
+	uint32_t length;
+	uint32_t cursor;
+
+	GeometryType type;
+	bool is_empty;
+	uint32_t geom_size;
+
+public:
+	WKBTranscoder(const char *data, uint32_t length)
+	    : data(data), length(length), cursor(0), type(GeometryType::POINT), is_empty(true), geom_size(0) {
+	}
+
+	static string_t Transcode(Vector &result, const char *data, uint32_t length);
+	static string_t Transcode(VectorStringBuffer &buffer, const char *data, uint32_t length);
+
+private:
+	// Validate the input and compute the size of the serialized geometry
+	uint32_t Measure();
+	// Write the serialized geometry into a blob of the size returned by Measure()
+	void Write(string_t &blob);
+
+	template <WKBByteOrder ORDER>
+	uint32_t ReadInt();
+	template <WKBByteOrder ORDER>
+	double ReadDouble();
+	template <WKBByteOrder ORDER>
+	WKBGeometryType ReadType();
+	WKBByteOrder ReadByteOrder();
+	void SkipVertices(uint32_t count);
+
+	uint32_t MeasureGeometry(bool is_root, bool has_expected_type, WKBGeometryType expected_type);
+	template <WKBByteOrder ORDER>
+	uint32_t MeasureGeometryBody(bool is_root, WKBGeometryType type);
+
+	void WriteGeometry(Cursor &out, BoundingBox &bbox);
+	template <WKBByteOrder ORDER>
+	void WriteGeometryBody(Cursor &out, BoundingBox &bbox, WKBGeometryType type);
+	template <WKBByteOrder ORDER>
+	void WriteVertices(Cursor &out, BoundingBox &bbox, uint32_t count, bool update_bounds);
+};
+
+} // namespace core
+
+} // namespace spatial
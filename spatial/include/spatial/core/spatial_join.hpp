@@ -0,0 +1,92 @@
+#pragma once
+#include "spatial/common.hpp"
+
+#include "duckdb/execution/operator/join/physical_join.hpp"
+#include "duckdb/planner/operator/logical_extension_operator.hpp"
+
+namespace spatial {
+
+namespace core {
+
+//------------------------------------------------------------------------------
+// Logical Spatial Join
+//------------------------------------------------------------------------------
+// An INNER join on a spatial predicate between two GEOMETRY expressions, one
+// from each side of the join. Emitted by the optimizer in place of an ANY join.
+class LogicalSpatialJoin : public LogicalExtensionOperator {
+public:
+	LogicalSpatialJoin(unique_ptr<Expression> condition, unique_ptr<Expression> left_key,
+	                   unique_ptr<Expression> right_key);
+
+	// The full join condition (e.g. st_intersects(a.geom, b.geom))
+	unique_ptr<Expression> condition;
+	// The geometry argument of the predicate that references the left side
+	unique_ptr<Expression> left_key;
+	// The geometry argument of the predicate that references the right side
+	unique_ptr<Expression> right_key;
+
+	vector<ColumnBinding> GetColumnBindings() override;
+	unique_ptr<PhysicalOperator> CreatePlan(ClientContext &context, PhysicalPlanGenerator &generator) override;
+	string GetName() const override;
+	string ParamsToString() const override;
+
+protected:
+	void ResolveTypes() override;
+};
+
+//------------------------------------------------------------------------------
+// Physical Spatial Join
+//------------------------------------------------------------------------------
+// Sinks the build side, materializes it and bulk loads an R-tree over the
+// bounding boxes of its geometries. The probe side then streams through the
+// operator, each probe geometry is looked up in the R-tree and the candidate
+// pairs are filtered by evaluating the exact join condition.
+class PhysicalSpatialJoin : public PhysicalJoin {
+public:
+	PhysicalSpatialJoin(LogicalOperator &op, unique_ptr<PhysicalOperator> probe, unique_ptr<PhysicalOperator> build,
+	                    unique_ptr<Expression> condition, unique_ptr<Expression> probe_key,
+	                    unique_ptr<Expression> build_key, bool build_is_left, idx_t estimated_cardinality);
+
+	// The join condition, resolved against the (left, right) column layout of the join
+	unique_ptr<Expression> condition;
+	// The geometry expression to probe with, resolved against the probe side
+	unique_ptr<Expression> probe_key;
+	// The geometry expression to index, resolved against the build side
+	unique_ptr<Expression> build_key;
+	// Whether the build side is the left side of the logical join
+	bool build_is_left;
+
+public:
+	string GetName() const override;
+	string ParamsToString() const override;
+
+	// Operator interface
+	unique_ptr<OperatorState> GetOperatorState(ExecutionContext &context) const override;
+	bool ParallelOperator() const override {
+		return true;
+	}
+
+protected:
+	OperatorResultType ExecuteInternal(ExecutionContext &context, DataChunk &input, DataChunk &chunk,
+	                                   GlobalOperatorState &gstate, OperatorState &state) const override;
+
+public:
+	// Sink interface
+	unique_ptr<GlobalSinkState> GetGlobalSinkState(ClientContext &context) const override;
+	unique_ptr<LocalSinkState> GetLocalSinkState(ExecutionContext &context) const override;
+	SinkResultType Sink(ExecutionContext &context, DataChunk &chunk, OperatorSinkInput &input) const override;
+	SinkCombineResultType Combine(ExecutionContext &context, OperatorSinkCombineInput &input) const override;
+	SinkFinalizeType Finalize(Pipeline &pipeline, Event &event, ClientContext &context,
+	                          OperatorSinkFinalizeInput &input) const override;
+
+	bool IsSink() const override {
+		return true;
+	}
+	bool ParallelSink() const override {
+		return true;
+	}
+};
+
+} // namespace core
+
+} // namespace spatial
@@ -6,9 +6,30 @@ namespace spatial {
 
 namespace gdal {
 
+struct GdalFileHandlerStats {
+	// bytes requested by GDAL
+	idx_t bytes_requested = 0;
+	// bytes and reads issued to the DuckDB file system
+	idx_t bytes_read = 0;
+	idx_t reads = 0;
+	// seeks that moved the position of a file
+	idx_t seeks = 0;
+	// blocks served from the read-ahead buffers and the block cache, or read from the file
+	idx_t cache_hits = 0;
+	idx_t cache_misses = 0;
+};
+
 struct GdalFileHandler {
 	static void Register();
 
+	// The name of the setting that controls the size of the block cache shared by all files opened through GDAL
+	static constexpr const char *BLOCK_CACHE_SIZE_SETTING = "gdal_block_cache_size";
+	static constexpr idx_t DEFAULT_BLOCK_CACHE_SIZE = 64 * 1024 * 1024;
+	static void RegisterSettings(DatabaseInstance &db);
+
+	// The I/O counters of all files opened through GDAL so far
+	static GdalFileHandlerStats GetStats();
+
 	// This is a workaround to allow the global file handler to access the current client context
 	// by storing it in a thread_local variable before executing a GDAL IO operation
 	static void SetLocalClientContext(ClientContext &context);
@@ -6,10 +6,15 @@
 
 #include "spatial/common.hpp"
 
+class OGRLayer;
+
 namespace spatial {
 
 namespace gdal {
 
+struct GdalScanFunctionData;
+struct GdalLayerSchema;
+
 struct GdalTableFunction : ArrowTableFunction {
 private:
 	static unique_ptr<FunctionData> Bind(ClientContext &context, TableFunctionBindInput &input,
@@ -26,11 +31,17 @@ private:
 
 	static unique_ptr<NodeStatistics> Cardinality(ClientContext &context, const FunctionData *data);
 
+	static void PushdownComplexFilter(ClientContext &context, LogicalGet &get, FunctionData *bind_data,
+	                                  vector<unique_ptr<Expression>> &filters);
+
 	static unique_ptr<TableRef> ReplacementScan(ClientContext &context, const string &table_name,
 	                                            ReplacementScanData *data);
 
 public:
 	static void Register(DatabaseInstance &db);
+
+	// Reads the columns of a layer from the schema of its arrow stream
+	static void BindLayerSchema(OGRLayer *layer, const GdalScanFunctionData &data, GdalLayerSchema &result);
 };
 
 struct GdalDriversTableFunction {
@@ -56,6 +67,10 @@ struct GdalCopyFunction {
 	static void Register(DatabaseInstance &db);
 };
 
+struct GdalIOStatsTableFunction {
+	static void Register(DatabaseInstance &db);
+};
+
 } // namespace gdal
 
 } // namespace spatial
\ No newline at end of file
@@ -2,6 +2,7 @@
 #include "spatial/common.hpp"
 #include "spatial/core/geometry/geometry_factory.hpp"
 #include "spatial/geos/geos_wrappers.hpp"
+#include "spatial/geos/geos_prepared_cache.hpp"
 namespace spatial {
 
 namespace geos {
@@ -10,6 +11,7 @@ struct GEOSFunctionLocalState : FunctionLocalState {
 public:
 	GeosContextWrapper ctx;
 	core::GeometryFactory factory;
+	PreparedGeometryCache prepared_cache;
 
 public:
 	explicit GEOSFunctionLocalState(ClientContext &context);
@@ -0,0 +1,14 @@
+#pragma once
+#include "spatial/common.hpp"
+
+namespace spatial {
+
+namespace geos {
+
+struct GeosTableFunctions {
+	static void Register(DatabaseInstance &db);
+};
+
+} // namespace geos
+
+} // namespace spatial
@@ -2,6 +2,7 @@
 
 #include "spatial/common.hpp"
 #include "spatial/core/types.hpp"
+#include "spatial/core/geometry/geometry_factory.hpp"
 #include "spatial/geos/functions/scalar.hpp"
 #include "spatial/geos/functions/common.hpp"
 #include "spatial/geos/geos_wrappers.hpp"
@@ -25,12 +26,262 @@ typedef char (*GEOSBinaryPredicate)(GEOSContextHandle_t ctx, const GEOSGeometry
 typedef char (*GEOSPreparedBinaryPredicate)(GEOSContextHandle_t ctx, const GEOSPreparedGeometry *left,
                                             const GEOSGeometry *right);
 
+//------------------------------------------------------------------------------
+// Prefilters
+//------------------------------------------------------------------------------
+// Most pairs passed to a predicate (especially in joins) can be decided by only looking at the bounding boxes
+// stored in the serialized geometry header, without deserializing them into GEOS geometries at all.
+
+enum class PrefilterResult : uint8_t { UNDECIDED, MATCH, NO_MATCH };
+
+typedef PrefilterResult (*GEOSPrefilter)(const string_t &left, const string_t &right);
+
+// What we know about a serialized geometry without deserializing it
+class PrefilterShape {
+public:
+	explicit PrefilterShape(const string_t &blob_p) : blob(blob_p) {
+		is_empty = !core::GeometryFactory::TryGetSerializedBoundingBox(blob, bbox);
+		is_point = !is_empty && core::GeometryHeader::Get(blob).type == core::GeometryType::POINT;
+	}
+
+	// Points have an exact bounding box
+	bool IsPoint() const {
+		return is_point;
+	}
+
+	bool IsEmpty() const {
+		return is_empty;
+	}
+
+	// The bounding box is stored as floats rounded outwards, so it may be slightly larger than the geometry.
+	// Once a geometry is known to be a rectangle this is replaced by the exact extent.
+	const core::BoundingBox &Bounds() const {
+		return bbox;
+	}
+
+	// Check (lazily, as it requires reading the vertices) if the geometry is an axis-aligned rectangle,
+	// in which case the geometry is equal to its bounding box.
+	bool IsRectangle() {
+		if (rectangle_state == RectangleState::UNKNOWN) {
+			core::BoundingBox exact;
+			if (!is_point && !is_empty && core::GeometryFactory::TryGetSerializedRectangle(blob, exact)) {
+				bbox = exact;
+				rectangle_state = RectangleState::RECTANGLE;
+			} else {
+				rectangle_state = RectangleState::NOT_RECTANGLE;
+			}
+		}
+		return rectangle_state == RectangleState::RECTANGLE;
+	}
+
+	// True if the whole geometry is known to be equal to its bounding box
+	bool IsExact() {
+		return is_point || IsRectangle();
+	}
+
+private:
+	enum class RectangleState : uint8_t { UNKNOWN, RECTANGLE, NOT_RECTANGLE };
+
+	const string_t &blob;
+	core::BoundingBox bbox;
+	bool is_empty;
+	bool is_point;
+	RectangleState rectangle_state = RectangleState::UNKNOWN;
+};
+
+// Empty geometries are always left to GEOS, as they have some surprising semantics (e.g. two empties are equal).
+struct GEOSPrefilters {
+	static PrefilterResult Intersects(const string_t &left_blob, const string_t &right_blob) {
+		PrefilterShape left(left_blob);
+		PrefilterShape right(right_blob);
+		if (left.IsEmpty() || right.IsEmpty()) {
+			return PrefilterResult::UNDECIDED;
+		}
+		if (!left.Bounds().Intersects(right.Bounds())) {
+			return PrefilterResult::NO_MATCH;
+		}
+		// If one side is equal to its bounding box, and the other is within it, they must intersect
+		if ((left.IsExact() && left.Bounds().Contains(right.Bounds())) ||
+		    (right.IsExact() && right.Bounds().Contains(left.Bounds()))) {
+			return PrefilterResult::MATCH;
+		}
+		// Two exact shapes intersect if their exact bounding boxes do
+		if (left.IsExact() && right.IsExact()) {
+			return left.Bounds().Intersects(right.Bounds()) ? PrefilterResult::MATCH : PrefilterResult::NO_MATCH;
+		}
+		return PrefilterResult::UNDECIDED;
+	}
+
+	static PrefilterResult Disjoint(const string_t &left_blob, const string_t &right_blob) {
+		switch (Intersects(left_blob, right_blob)) {
+		case PrefilterResult::MATCH:
+			return PrefilterResult::NO_MATCH;
+		case PrefilterResult::NO_MATCH:
+			return PrefilterResult::MATCH;
+		default:
+			return PrefilterResult::UNDECIDED;
+		}
+	}
+
+	static PrefilterResult Covers(const string_t &left_blob, const string_t &right_blob) {
+		PrefilterShape left(left_blob);
+		PrefilterShape right(right_blob);
+		if (left.IsEmpty() || right.IsEmpty()) {
+			return PrefilterResult::UNDECIDED;
+		}
+		// The bounding box of the covered geometry has to be within the bounding box of the covering one.
+		// This also holds for the rounded bounding boxes, as the rounding is monotonic.
+		if (!left.Bounds().Contains(right.Bounds())) {
+			return PrefilterResult::NO_MATCH;
+		}
+		// Anything within the bounding box of an exact shape is covered by it
+		if (left.IsExact() && left.Bounds().Contains(right.Bounds())) {
+			return PrefilterResult::MATCH;
+		}
+		return PrefilterResult::UNDECIDED;
+	}
+
+	static PrefilterResult CoveredBy(const string_t &left_blob, const string_t &right_blob) {
+		return Covers(right_blob, left_blob);
+	}
+
+	static PrefilterResult Contains(const string_t &left_blob, const string_t &right_blob) {
+		PrefilterShape left(left_blob);
+		PrefilterShape right(right_blob);
+		if (left.IsEmpty() || right.IsEmpty()) {
+			return PrefilterResult::UNDECIDED;
+		}
+		if (!left.Bounds().Contains(right.Bounds())) {
+			return PrefilterResult::NO_MATCH;
+		}
+		if (left.IsPoint()) {
+			// Both are the same point
+			return right.IsPoint() ? PrefilterResult::MATCH : PrefilterResult::UNDECIDED;
+		}
+		if (left.IsRectangle()) {
+			// Anything strictly inside a rectangle is contained by it,
+			// and so is a rectangle within a rectangle, as their interiors always intersect.
+			if (left.Bounds().ContainsProperly(right.Bounds()) ||
+			    (right.IsRectangle() && left.Bounds().Contains(right.Bounds()))) {
+				return PrefilterResult::MATCH;
+			}
+			// A point on the boundary of (or outside) a polygon is not contained by it
+			if (right.IsPoint()) {
+				return PrefilterResult::NO_MATCH;
+			}
+		}
+		return PrefilterResult::UNDECIDED;
+	}
+
+	static PrefilterResult Within(const string_t &left_blob, const string_t &right_blob) {
+		return Contains(right_blob, left_blob);
+	}
+
+	static PrefilterResult ContainsProperly(const string_t &left_blob, const string_t &right_blob) {
+		PrefilterShape left(left_blob);
+		PrefilterShape right(right_blob);
+		if (left.IsEmpty() || right.IsEmpty()) {
+			return PrefilterResult::UNDECIDED;
+		}
+		if (!left.Bounds().Contains(right.Bounds())) {
+			return PrefilterResult::NO_MATCH;
+		}
+		if (left.IsRectangle()) {
+			// The rounded bounds of the other side may reach the boundary of the rectangle even if the geometry
+			// itself does not, so swap in its exact bounds (if any) before testing
+			auto right_exact = right.IsExact();
+			if (left.Bounds().ContainsProperly(right.Bounds())) {
+				return PrefilterResult::MATCH;
+			}
+			if (right_exact) {
+				// Touches the boundary of the rectangle
+				return PrefilterResult::NO_MATCH;
+			}
+		}
+		return PrefilterResult::UNDECIDED;
+	}
+
+	static PrefilterResult Touches(const string_t &left_blob, const string_t &right_blob) {
+		PrefilterShape left(left_blob);
+		PrefilterShape right(right_blob);
+		if (left.IsEmpty() || right.IsEmpty()) {
+			return PrefilterResult::UNDECIDED;
+		}
+		if (!left.Bounds().Intersects(right.Bounds())) {
+			return PrefilterResult::NO_MATCH;
+		}
+		// Points have no boundary, so two (equal) points never touch
+		if (left.IsPoint() && right.IsPoint()) {
+			return PrefilterResult::NO_MATCH;
+		}
+		// Something strictly inside a rectangle intersects its interior
+		if ((left.IsRectangle() && left.Bounds().ContainsProperly(right.Bounds())) ||
+		    (right.IsRectangle() && right.Bounds().ContainsProperly(left.Bounds()))) {
+			return PrefilterResult::NO_MATCH;
+		}
+		// A point is either on the boundary of a rectangle, or outside of it
+		if (left.IsRectangle() && right.IsPoint()) {
+			return left.Bounds().Contains(right.Bounds()) ? PrefilterResult::MATCH : PrefilterResult::NO_MATCH;
+		}
+		if (left.IsPoint() && right.IsRectangle()) {
+			return right.Bounds().Contains(left.Bounds()) ? PrefilterResult::MATCH : PrefilterResult::NO_MATCH;
+		}
+		return PrefilterResult::UNDECIDED;
+	}
+
+	// Overlaps and Crosses require the geometries to intersect, but we can't tell much more from the header alone
+	static PrefilterResult BoundsIntersect(const string_t &left_blob, const string_t &right_blob) {
+		PrefilterShape left(left_blob);
+		PrefilterShape right(right_blob);
+		if (left.IsEmpty() || right.IsEmpty()) {
+			return PrefilterResult::UNDECIDED;
+		}
+		if (!left.Bounds().Intersects(right.Bounds())) {
+			return PrefilterResult::NO_MATCH;
+		}
+		return PrefilterResult::UNDECIDED;
+	}
+
+	static PrefilterResult Equals(const string_t &left_blob, const string_t &right_blob) {
+		PrefilterShape left(left_blob);
+		PrefilterShape right(right_blob);
+		if (left.IsEmpty() || right.IsEmpty()) {
+			return PrefilterResult::UNDECIDED;
+		}
+		// The rounded bounding boxes of equal geometries may differ (e.g. a point and a multipoint),
+		// but they will always intersect
+		if (!left.Bounds().Intersects(right.Bounds())) {
+			return PrefilterResult::NO_MATCH;
+		}
+		if (left.IsPoint() && right.IsPoint()) {
+			return PrefilterResult::MATCH;
+		}
+		if (left.IsRectangle() && right.IsRectangle()) {
+			auto &l = left.Bounds();
+			auto &r = right.Bounds();
+			auto equal = l.minx == r.minx && l.miny == r.miny && l.maxx == r.maxx && l.maxy == r.maxy;
+			return equal ? PrefilterResult::MATCH : PrefilterResult::NO_MATCH;
+		}
+		return PrefilterResult::UNDECIDED;
+	}
+
+	// Returns true and sets result if the pair could be decided without deserializing
+	static inline bool TryDecide(GEOSPrefilter prefilter, const string_t &left, const string_t &right, bool &result) {
+		auto decision = prefilter(left, right);
+		if (decision == PrefilterResult::UNDECIDED) {
+			return false;
+		}
+		result = decision == PrefilterResult::MATCH;
+		return true;
+	}
+};
+
 struct GEOSExecutor {
 	// Symmetric: left and right can be swapped
 	// So we prepare either if one is constant
 	static void ExecuteSymmetricPreparedBinary(GEOSFunctionLocalState &lstate, Vector &left, Vector &right, idx_t count,
 	                                           Vector &result, GEOSBinaryPredicate normal,
-	                                           GEOSPreparedBinaryPredicate prepared) {
+	                                           GEOSPreparedBinaryPredicate prepared, GEOSPrefilter prefilter) {
 		auto &ctx = lstate.ctx.GetCtx();
 
 		if (left.GetVectorType() == VectorType::CONSTANT_VECTOR &&
@@ -40,6 +291,10 @@ struct GEOSExecutor {
 			auto left_prepared = make_uniq_geos(ctx, GEOSPrepare_r(ctx, left_geom.get()));
 
 			UnaryExecutor::Execute<string_t, bool>(right, result, count, [&](string_t &right_blob) {
+				bool decided;
+				if (GEOSPrefilters::TryDecide(prefilter, left_blob, right_blob, decided)) {
+					return decided;
+				}
 				auto right_geometry = lstate.ctx.Deserialize(right_blob);
 				auto ok = prepared(ctx, left_prepared.get(), right_geometry.get());
 				return ok == 1;
@@ -51,13 +306,33 @@ struct GEOSExecutor {
 			auto right_prepared = make_uniq_geos(ctx, GEOSPrepare_r(ctx, right_geom.get()));
 
 			UnaryExecutor::Execute<string_t, bool>(left, result, count, [&](string_t &left_blob) {
+				bool decided;
+				if (GEOSPrefilters::TryDecide(prefilter, left_blob, right_blob, decided)) {
+					return decided;
+				}
 				auto left_geometry = lstate.ctx.Deserialize(left_blob);
 				auto ok = prepared(ctx, right_prepared.get(), left_geometry.get());
 				return ok == 1;
 			});
 		} else {
+			// Neither is constant, but the same geometry may still repeat across rows (e.g. in joins),
+			// so try to use a cached prepared version of either side.
 			BinaryExecutor::Execute<string_t, string_t, bool>(
 			    left, right, result, count, [&](string_t &left_blob, string_t &right_blob) {
+				    bool decided;
+				    if (GEOSPrefilters::TryDecide(prefilter, left_blob, right_blob, decided)) {
+					    return decided;
+				    }
+				    auto left_prepared = lstate.prepared_cache.Get(left_blob);
+				    if (left_prepared) {
+					    auto right_geometry = lstate.ctx.Deserialize(right_blob);
+					    return prepared(ctx, left_prepared, right_geometry.get()) == 1;
+				    }
+				    auto right_prepared = lstate.prepared_cache.Get(right_blob);
+				    if (right_prepared) {
+					    auto left_geometry = lstate.ctx.Deserialize(left_blob);
+					    return prepared(ctx, right_prepared, left_geometry.get()) == 1;
+				    }
 				    auto left_geometry = lstate.ctx.Deserialize(left_blob);
 				    auto right_geometry = lstate.ctx.Deserialize(right_blob);
 				    auto ok = normal(ctx, left_geometry.get(), right_geometry.get());
@@ -67,10 +342,13 @@ struct GEOSExecutor {
 	}
 
 	// Non symmetric: left and right cannot be swapped
-	// So we only prepare left if left is constant
+	// So we prepare left with the predicate itself, or right with its converse
+	// (e.g. Contains for Within), i.e. prepared_converse(right, left) == normal(left, right).
 	static void ExecuteNonSymmetricPreparedBinary(GEOSFunctionLocalState &lstate, Vector &left, Vector &right,
 	                                              idx_t count, Vector &result, GEOSBinaryPredicate normal,
-	                                              GEOSPreparedBinaryPredicate prepared) {
+	                                              GEOSPreparedBinaryPredicate prepared,
+	                                              GEOSPreparedBinaryPredicate prepared_converse,
+	                                              GEOSPrefilter prefilter) {
 		auto &ctx = lstate.ctx.GetCtx();
 
 		// Optimize: if one of the arguments is a constant, we can prepare it once and reuse it
@@ -81,13 +359,46 @@ struct GEOSExecutor {
 			auto left_prepared = make_uniq_geos(ctx, GEOSPrepare_r(ctx, left_geom.get()));
 
 			UnaryExecutor::Execute<string_t, bool>(right, result, count, [&](string_t &right_blob) {
+				bool decided;
+				if (GEOSPrefilters::TryDecide(prefilter, left_blob, right_blob, decided)) {
+					return decided;
+				}
 				auto right_geometry = lstate.ctx.Deserialize(right_blob);
 				auto ok = prepared(ctx, left_prepared.get(), right_geometry.get());
 				return ok == 1;
 			});
+		} else if (right.GetVectorType() == VectorType::CONSTANT_VECTOR &&
+		           left.GetVectorType() != VectorType::CONSTANT_VECTOR) {
+			auto &right_blob = FlatVector::GetData<string_t>(right)[0];
+			auto right_geom = lstate.ctx.Deserialize(right_blob);
+			auto right_prepared = make_uniq_geos(ctx, GEOSPrepare_r(ctx, right_geom.get()));
+
+			UnaryExecutor::Execute<string_t, bool>(left, result, count, [&](string_t &left_blob) {
+				bool decided;
+				if (GEOSPrefilters::TryDecide(prefilter, left_blob, right_blob, decided)) {
+					return decided;
+				}
+				auto left_geometry = lstate.ctx.Deserialize(left_blob);
+				auto ok = prepared_converse(ctx, right_prepared.get(), left_geometry.get());
+				return ok == 1;
+			});
 		} else {
 			BinaryExecutor::Execute<string_t, string_t, bool>(
 			    left, right, result, count, [&](string_t &left_blob, string_t &right_blob) {
+				    bool decided;
+				    if (GEOSPrefilters::TryDecide(prefilter, left_blob, right_blob, decided)) {
+					    return decided;
+				    }
+				    auto left_prepared = lstate.prepared_cache.Get(left_blob);
+				    if (left_prepared) {
+					    auto right_geometry = lstate.ctx.Deserialize(right_blob);
+					    return prepared(ctx, left_prepared, right_geometry.get()) == 1;
+				    }
+				    auto right_prepared = lstate.prepared_cache.Get(right_blob);
+				    if (right_prepared) {
+					    auto left_geometry = lstate.ctx.Deserialize(left_blob);
+					    return prepared_converse(ctx, right_prepared, left_geometry.get()) == 1;
+				    }
 				    auto left_geometry = lstate.ctx.Deserialize(left_blob);
 				    auto right_geometry = lstate.ctx.Deserialize(right_blob);
 				    auto ok = normal(ctx, left_geometry.get(), right_geometry.get());
@@ -0,0 +1,68 @@
+#pragma once
+#include "spatial/common.hpp"
+#include "spatial/geos/geos_wrappers.hpp"
+
+#include "duckdb/common/unordered_map.hpp"
+#include "duckdb/common/unordered_set.hpp"
+
+#include <list>
+
+namespace spatial {
+
+namespace geos {
+
+using PreparedGeometryPtr = unique_ptr<const GEOSPreparedGeometry, GeosDeleter<const GEOSPreparedGeometry>>;
+
+struct PreparedGeometryCacheStats {
+	idx_t hits = 0;
+	idx_t misses = 0;
+	idx_t evictions = 0;
+};
+
+// A LRU cache of prepared geometries, keyed on the contents of the serialized geometry.
+// Join outputs often repeat the same (large) geometry many times in flat vectors, where we would otherwise
+// deserialize and evaluate it from scratch for every row. Prepared geometries are bound to the GEOS context that
+// created them, so each (thread-local) function state owns its own cache.
+class PreparedGeometryCache {
+public:
+	PreparedGeometryCache(GeosContextWrapper &ctx, idx_t memory_budget);
+	~PreparedGeometryCache();
+
+	// Returns the prepared geometry for the blob, or nullptr if it should be evaluated without preparing it.
+	// Geometries are only prepared the second time they are seen, so that geometries that never repeat
+	// don't pay for the preparation.
+	const GEOSPreparedGeometry *Get(const string_t &blob);
+
+	// The per-thread cache budget, derived from the database memory limit
+	static idx_t GetMemoryBudget(ClientContext &context);
+
+	// The statistics of all caches, collected when they are destroyed
+	static PreparedGeometryCacheStats GetGlobalStats();
+
+private:
+	struct Entry {
+		hash_t hash;
+		string blob;
+		GeometryPtr geometry;
+		PreparedGeometryPtr prepared;
+		idx_t size;
+	};
+
+	void Evict();
+
+	GeosContextWrapper &ctx;
+	idx_t memory_budget;
+	idx_t memory_usage = 0;
+
+	// Most recently used entries are at the front
+	std::list<Entry> entries;
+	unordered_map<hash_t, std::list<Entry>::iterator> index;
+	// Hashes of geometries seen once, that will be prepared the next time they are seen
+	unordered_set<hash_t> candidates;
+
+	PreparedGeometryCacheStats stats;
+};
+
+} // namespace geos
+
+} // namespace spatial
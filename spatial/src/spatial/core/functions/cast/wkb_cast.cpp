@@ -3,6 +3,7 @@
 #include "spatial/core/functions/cast.hpp"
 #include "spatial/core/functions/common.hpp"
 #include "spatial/core/geometry/wkb_writer.hpp"
+#include "spatial/core/geometry/wkb_transcoder.hpp"
 
 #include "duckdb/function/cast/cast_function_set.hpp"
 #include "duckdb/common/vector_operations/generic_executor.hpp"
@@ -15,11 +16,8 @@ namespace core {
 // WKB -> GEOMETRY
 //------------------------------------------------------------------------------
 static bool WKBToGeometryCast(Vector &source, Vector &result, idx_t count, CastParameters &parameters) {
-	auto &lstate = GeometryFunctionLocalState::ResetAndGet(parameters);
-
 	UnaryExecutor::Execute<string_t, string_t>(source, result, count, [&](string_t input) {
-		auto geometry = lstate.factory.FromWKB(input.GetDataUnsafe(), input.GetSize());
-		return lstate.factory.Serialize(result, geometry);
+		return WKBTranscoder::Transcode(result, input.GetDataUnsafe(), input.GetSize());
 	});
 	return true;
 }
@@ -54,7 +52,7 @@ void CoreCastFunctions::RegisterWKBCasts(DatabaseInstance &db) {
 
 	ExtensionUtil::RegisterCastFunction(
 	    db, GeoTypes::WKB_BLOB(), GeoTypes::GEOMETRY(),
-	    BoundCastInfo(WKBToGeometryCast, nullptr, GeometryFunctionLocalState::InitCast));
+	    BoundCastInfo(WKBToGeometryCast));
 
 	// WKB -> BLOB is implicitly castable
 	ExtensionUtil::RegisterCastFunction(db, GeoTypes::WKB_BLOB(), LogicalType::BLOB, DefaultCasts::ReinterpretCast, 1);
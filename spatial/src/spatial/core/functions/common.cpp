@@ -1,5 +1,11 @@
 #include "spatial/common.hpp"
 #include "spatial/core/functions/common.hpp"
+#include "spatial/core/types.hpp"
+
+#include "duckdb/planner/expression/bound_columnref_expression.hpp"
+#include "duckdb/planner/expression/bound_comparison_expression.hpp"
+#include "duckdb/planner/expression/bound_constant_expression.hpp"
+#include "duckdb/planner/expression/bound_function_expression.hpp"
 
 namespace spatial {
 
@@ -30,6 +36,125 @@ GeometryFunctionLocalState &GeometryFunctionLocalState::ResetAndGet(ExpressionSt
 	return local_state;
 }
 
+//------------------------------------------------------------------------------
+// Spatial Filter Pushdown
+//------------------------------------------------------------------------------
+static bool TryGetConstantBox(const Expression &expr, BoundingBox &bbox) {
+	if (expr.type != ExpressionType::VALUE_CONSTANT || expr.return_type != GeoTypes::GEOMETRY()) {
+		return false;
+	}
+	auto &value = expr.Cast<BoundConstantExpression>().value;
+	if (value.IsNull()) {
+		return false;
+	}
+	auto &blob = StringValue::Get(value);
+	return GeometryFactory::TryGetSerializedBoundingBox(string_t(blob.c_str(), blob.size()), bbox);
+}
+
+static bool IsColumnRef(const Expression &expr, LogicalGet &get, idx_t column_idx) {
+	if (expr.type != ExpressionType::BOUND_COLUMN_REF) {
+		return false;
+	}
+	auto &colref = expr.Cast<BoundColumnRefExpression>();
+	return colref.binding.table_index == get.table_index && colref.binding.column_index < get.column_ids.size() &&
+	       get.column_ids[colref.binding.column_index] == column_idx;
+}
+
+// Returns the constant, if the comparison bounds the extent of the geometry column from within
+static bool TryGetExtentBound(const Expression &expr, LogicalGet &get, idx_t column_idx, BoundingBox &bounds) {
+	if (expr.GetExpressionClass() != ExpressionClass::BOUND_COMPARISON) {
+		return false;
+	}
+	auto &comparison = expr.Cast<BoundComparisonExpression>();
+	auto comparison_type = comparison.type;
+	auto func_expr = comparison.left.get();
+	auto const_expr = comparison.right.get();
+	if (func_expr->type == ExpressionType::VALUE_CONSTANT) {
+		std::swap(func_expr, const_expr);
+		comparison_type = FlipComparisonExpression(comparison_type);
+	}
+	if (func_expr->type != ExpressionType::BOUND_FUNCTION || const_expr->type != ExpressionType::VALUE_CONSTANT ||
+	    const_expr->return_type != LogicalType::DOUBLE) {
+		return false;
+	}
+	auto &func = func_expr->Cast<BoundFunctionExpression>();
+	if (func.children.size() != 1 || !IsColumnRef(*func.children[0], get, column_idx)) {
+		return false;
+	}
+	auto &value = const_expr->Cast<BoundConstantExpression>().value;
+	if (value.IsNull()) {
+		return false;
+	}
+	auto constant = DoubleValue::Get(value);
+
+	auto is_lower_bound = comparison_type == ExpressionType::COMPARE_GREATERTHAN ||
+	                      comparison_type == ExpressionType::COMPARE_GREATERTHANOREQUALTO ||
+	                      comparison_type == ExpressionType::COMPARE_EQUAL;
+	auto is_upper_bound = comparison_type == ExpressionType::COMPARE_LESSTHAN ||
+	                      comparison_type == ExpressionType::COMPARE_LESSTHANOREQUALTO ||
+	                      comparison_type == ExpressionType::COMPARE_EQUAL;
+
+	// The serialized bounding box is rounded outwards, so these still hold for the exact extent
+	auto &name = func.function.name;
+	if (is_lower_bound && StringUtil::CIEquals(name, "st_xmin")) {
+		bounds.minx = MaxValue(bounds.minx, constant);
+	} else if (is_lower_bound && StringUtil::CIEquals(name, "st_ymin")) {
+		bounds.miny = MaxValue(bounds.miny, constant);
+	} else if (is_upper_bound && StringUtil::CIEquals(name, "st_xmax")) {
+		bounds.maxx = MinValue(bounds.maxx, constant);
+	} else if (is_upper_bound && StringUtil::CIEquals(name, "st_ymax")) {
+		bounds.maxy = MinValue(bounds.maxy, constant);
+	} else {
+		return false;
+	}
+	return true;
+}
+
+void SpatialFilterPushdown::GetFilterBoxes(LogicalGet &get, const vector<unique_ptr<Expression>> &filters,
+                                           idx_t column_idx, bool exact, vector<BoundingBox> &result) {
+	// All spatial predicates (except st_disjoint) imply an intersection of the bounding boxes
+	case_insensitive_set_t predicates = {"st_equals",    "st_intersects",      "st_touches",  "st_crosses",
+	                                     "st_within",    "st_contains",        "st_overlaps", "st_covers",
+	                                     "st_coveredby", "st_containsproperly", "st_intersects_extent"};
+
+	// The rows that pass all of the extent comparisons lie within these bounds
+	BoundingBox extent_bounds;
+	extent_bounds.minx = NumericLimits<double>::Minimum();
+	extent_bounds.miny = NumericLimits<double>::Minimum();
+	extent_bounds.maxx = NumericLimits<double>::Maximum();
+	extent_bounds.maxy = NumericLimits<double>::Maximum();
+	bool has_extent_bounds = false;
+
+	for (auto &filter : filters) {
+		if (TryGetExtentBound(*filter, get, column_idx, extent_bounds)) {
+			has_extent_bounds = true;
+			continue;
+		}
+		if (filter->type != ExpressionType::BOUND_FUNCTION) {
+			continue;
+		}
+		auto &func = filter->Cast<BoundFunctionExpression>();
+		if (func.children.size() != 2 || predicates.find(func.function.name) == predicates.end()) {
+			continue;
+		}
+		if (exact && StringUtil::CIEquals(func.function.name, "st_intersects_extent")) {
+			continue;
+		}
+		auto &left = *func.children[0];
+		auto &right = *func.children[1];
+
+		BoundingBox bbox;
+		auto is_spatial_filter = (IsColumnRef(left, get, column_idx) && TryGetConstantBox(right, bbox)) ||
+		                         (IsColumnRef(right, get, column_idx) && TryGetConstantBox(left, bbox));
+		if (is_spatial_filter) {
+			result.push_back(bbox);
+		}
+	}
+	if (has_extent_bounds) {
+		result.push_back(extent_bounds);
+	}
+}
+
 } // namespace core
 
 } // namespace spatial
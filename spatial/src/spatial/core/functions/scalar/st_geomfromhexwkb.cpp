@@ -9,6 +9,7 @@
 #include "spatial/core/geometry/geometry_factory.hpp"
 #include "spatial/core/types.hpp"
 #include "spatial/core/geometry/wkb_writer.hpp"
+#include "spatial/core/geometry/wkb_transcoder.hpp"
 
 namespace spatial {
 
@@ -23,8 +24,6 @@ void GeometryFromHEXWKB(DataChunk &args, ExpressionState &state, Vector &result)
 	auto &input = args.data[0];
 	auto count = args.size();
 
-	auto &lstate = GeometryFunctionLocalState::ResetAndGet(state);
-
 	UnaryExecutor::Execute<string_t, string_t>(input, result, count, [&](string_t input_hex) {
 		auto hex_size = input_hex.GetSize();
 		auto hex_ptr = const_data_ptr_cast(input_hex.GetData());
@@ -47,8 +46,7 @@ void GeometryFromHEXWKB(DataChunk &args, ExpressionState &state, Vector &result)
 			blob_ptr[blob_idx++] = (byte_a << 4) + byte_b;
 		}
 
-		auto geom = lstate.factory.FromWKB((const char *)wkb_blob.get(), blob_size);
-		return lstate.factory.Serialize(result, geom);
+		return WKBTranscoder::Transcode(result, (const char *)wkb_blob.get(), blob_size);
 	});
 }
 
@@ -56,16 +54,14 @@ void GeometryFromHEXWKB(DataChunk &args, ExpressionState &state, Vector &result)
 //  Register functions
 //------------------------------------------------------------------------------
 void CoreScalarFunctions::RegisterStGeomFromHEXWKB(DatabaseInstance &db) {
-	ScalarFunction hexwkb("ST_GeomFromHEXWKB", {LogicalType::VARCHAR}, GeoTypes::GEOMETRY(), GeometryFromHEXWKB,
-	                      nullptr, nullptr, nullptr, GeometryFunctionLocalState::Init);
+	ScalarFunction hexwkb("ST_GeomFromHEXWKB", {LogicalType::VARCHAR}, GeoTypes::GEOMETRY(), GeometryFromHEXWKB);
 	ExtensionUtil::RegisterFunction(db, hexwkb);
 
 	// Our WKB reader also parses EWKB, even though it will just ignore SRID's.
 	// so we'll just add an alias for now. In the future, once we actually handle
 	// EWKB and store SRID's, these functions should differentiate between
 	// the two formats.
-	ScalarFunction ewkb("ST_GeomFromHEXEWKB", {LogicalType::VARCHAR}, GeoTypes::GEOMETRY(), GeometryFromHEXWKB, nullptr,
-	                    nullptr, nullptr, GeometryFunctionLocalState::Init);
+	ScalarFunction ewkb("ST_GeomFromHEXEWKB", {LogicalType::VARCHAR}, GeoTypes::GEOMETRY(), GeometryFromHEXWKB);
 	ExtensionUtil::RegisterFunction(db, ewkb);
 }
 
@@ -4,6 +4,7 @@
 #include "spatial/core/functions/common.hpp"
 #include "spatial/core/geometry/geometry.hpp"
 #include "spatial/core/geometry/geometry_factory.hpp"
+#include "spatial/core/geometry/wkb_transcoder.hpp"
 #include "spatial/core/types.hpp"
 
 namespace spatial {
@@ -267,13 +268,11 @@ static void Polygon2DFromWKBFunction(DataChunk &args, ExpressionState &state, Ve
 // GEOMETRY
 //------------------------------------------------------------------------------
 static void GeometryFromWKBFunction(DataChunk &args, ExpressionState &state, Vector &result) {
-	auto &lstate = GeometryFunctionLocalState::ResetAndGet(state);
 	auto &input = args.data[0];
 	auto count = args.size();
 
 	UnaryExecutor::Execute<string_t, string_t>(input, result, count, [&](string_t input) {
-		auto geometry = lstate.factory.FromWKB(input.GetDataUnsafe(), input.GetSize());
-		return lstate.factory.Serialize(result, geometry);
+		return WKBTranscoder::Transcode(result, input.GetDataUnsafe(), input.GetSize());
 	});
 }
 
@@ -295,10 +294,8 @@ void CoreScalarFunctions::RegisterStGeomFromWKB(DatabaseInstance &db) {
 	ExtensionUtil::RegisterFunction(db, polygon2d_from_wkb);
 
 	ScalarFunctionSet st_geom_from_wkb("ST_GeomFromWKB");
-	st_geom_from_wkb.AddFunction(ScalarFunction({GeoTypes::WKB_BLOB()}, GeoTypes::GEOMETRY(), GeometryFromWKBFunction,
-	                                            nullptr, nullptr, nullptr, GeometryFunctionLocalState::Init));
-	st_geom_from_wkb.AddFunction(ScalarFunction({LogicalType::BLOB}, GeoTypes::GEOMETRY(), GeometryFromWKBFunction,
-	                                            nullptr, nullptr, nullptr, GeometryFunctionLocalState::Init));
+	st_geom_from_wkb.AddFunction(ScalarFunction({GeoTypes::WKB_BLOB()}, GeoTypes::GEOMETRY(), GeometryFromWKBFunction));
+	st_geom_from_wkb.AddFunction(ScalarFunction({LogicalType::BLOB}, GeoTypes::GEOMETRY(), GeometryFromWKBFunction));
 
 	ExtensionUtil::RegisterFunction(db, st_geom_from_wkb);
 }
@@ -0,0 +1,120 @@
+#include "spatial/common.hpp"
+#include "spatial/core/types.hpp"
+#include "spatial/core/functions/scalar.hpp"
+#include "spatial/core/geometry/geometry_factory.hpp"
+#include "spatial/core/geometry/space_filling_curve.hpp"
+
+#include "duckdb/common/vector_operations/generic_executor.hpp"
+
+namespace spatial {
+
+namespace core {
+
+struct HilbertOp {
+	static inline uint32_t Encode(double x, double y, const BoundingBox &bounds) {
+		return SpaceFillingCurve::Hilbert(x, y, bounds);
+	}
+};
+
+struct ZOrderOp {
+	static inline uint32_t Encode(double x, double y, const BoundingBox &bounds) {
+		return SpaceFillingCurve::ZOrder(x, y, bounds);
+	}
+};
+
+//------------------------------------------------------------------------------
+// POINT_2D
+//------------------------------------------------------------------------------
+template <class OP>
+static void PointCurveFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	using POINT_TYPE = StructTypeBinary<double, double>;
+	using BOX_TYPE = StructTypeQuaternary<double, double, double, double>;
+	using UINT32_TYPE = PrimitiveType<uint32_t>;
+
+	GenericExecutor::ExecuteBinary<POINT_TYPE, BOX_TYPE, UINT32_TYPE>(
+	    args.data[0], args.data[1], result, args.size(), [&](POINT_TYPE &point, BOX_TYPE &box) {
+		    BoundingBox bounds;
+		    bounds.minx = box.a_val;
+		    bounds.miny = box.b_val;
+		    bounds.maxx = box.c_val;
+		    bounds.maxy = box.d_val;
+		    return OP::Encode(point.a_val, point.b_val, bounds);
+	    });
+}
+
+//------------------------------------------------------------------------------
+// GEOMETRY
+//------------------------------------------------------------------------------
+// Encodes the center of the bounding box, which is read from the serialized header
+// (or the coordinates of a point) without deserializing the geometry.
+// Empty geometries have no position and return NULL.
+template <class OP>
+static void GeometryCurveFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	auto count = args.size();
+	auto &input = args.data[0];
+	auto &bounds_vec = args.data[1];
+	// Checked before the bounds are flattened below
+	auto all_constant = args.AllConstant();
+
+	UnifiedVectorFormat format;
+	input.ToUnifiedFormat(count, format);
+	auto geometries = UnifiedVectorFormat::GetData<string_t>(format);
+
+	bounds_vec.Flatten(count);
+	auto &bounds_validity = FlatVector::Validity(bounds_vec);
+	auto &bounds_children = StructVector::GetEntries(bounds_vec);
+	auto minx_data = FlatVector::GetData<double>(*bounds_children[0]);
+	auto miny_data = FlatVector::GetData<double>(*bounds_children[1]);
+	auto maxx_data = FlatVector::GetData<double>(*bounds_children[2]);
+	auto maxy_data = FlatVector::GetData<double>(*bounds_children[3]);
+
+	auto result_data = FlatVector::GetData<uint32_t>(result);
+	for (idx_t out_row_idx = 0; out_row_idx < count; out_row_idx++) {
+		auto in_row_idx = format.sel->get_index(out_row_idx);
+		BoundingBox bbox;
+		if (!format.validity.RowIsValid(in_row_idx) || !bounds_validity.RowIsValid(out_row_idx) ||
+		    !GeometryFactory::TryGetSerializedBoundingBox(geometries[in_row_idx], bbox)) {
+			FlatVector::SetNull(result, out_row_idx, true);
+			continue;
+		}
+		BoundingBox bounds;
+		bounds.minx = minx_data[out_row_idx];
+		bounds.miny = miny_data[out_row_idx];
+		bounds.maxx = maxx_data[out_row_idx];
+		bounds.maxy = maxy_data[out_row_idx];
+
+		auto x = bbox.minx + (bbox.maxx - bbox.minx) * 0.5;
+		auto y = bbox.miny + (bbox.maxy - bbox.miny) * 0.5;
+		result_data[out_row_idx] = OP::Encode(x, y, bounds);
+	}
+	if (all_constant) {
+		result.SetVectorType(VectorType::CONSTANT_VECTOR);
+	}
+}
+
+//------------------------------------------------------------------------------
+// Register functions
+//------------------------------------------------------------------------------
+void CoreScalarFunctions::RegisterStHilbert(DatabaseInstance &db) {
+	ScalarFunctionSet set("ST_Hilbert");
+	set.AddFunction(ScalarFunction({GeoTypes::POINT_2D(), GeoTypes::BOX_2D()}, LogicalType::UINTEGER,
+	                               PointCurveFunction<HilbertOp>));
+	set.AddFunction(ScalarFunction({GeoTypes::GEOMETRY(), GeoTypes::BOX_2D()}, LogicalType::UINTEGER,
+	                               GeometryCurveFunction<HilbertOp>));
+
+	ExtensionUtil::RegisterFunction(db, set);
+}
+
+void CoreScalarFunctions::RegisterStZOrder(DatabaseInstance &db) {
+	ScalarFunctionSet set("ST_ZOrder");
+	set.AddFunction(ScalarFunction({GeoTypes::POINT_2D(), GeoTypes::BOX_2D()}, LogicalType::UINTEGER,
+	                               PointCurveFunction<ZOrderOp>));
+	set.AddFunction(ScalarFunction({GeoTypes::GEOMETRY(), GeoTypes::BOX_2D()}, LogicalType::UINTEGER,
+	                               GeometryCurveFunction<ZOrderOp>));
+
+	ExtensionUtil::RegisterFunction(db, set);
+}
+
+} // namespace core
+
+} // namespace spatial
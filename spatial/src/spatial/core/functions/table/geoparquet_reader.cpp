@@ -20,7 +20,9 @@
 #include "utf8proc_wrapper.hpp"
 #include "spatial/core/geometry/wkb_writer.hpp"
 
-#include <spatial/core/geometry/geometry_factory.hpp>
+#include <spatial/core/geometry/wkb_transcoder.hpp>
+
+#include "yyjson.h"
 
 namespace spatial {
 namespace core {
@@ -32,16 +34,19 @@ using duckdb::FieldRepetitionType;
 using duckdb_parquet::format::ConvertedType;
 using duckdb::ListColumnReader;
 using duckdb::StructColumnReader;
+using namespace duckdb_yyjson_spatial;
 
 
 GeoparquetReader::GeoparquetReader(ClientContext &context, string file_name, ParquetOptions parquet_options)
     : ParquetReader(context, file_name, parquet_options) {
 	GeoparquetReader::InitializeSchema();
+	InitializeGeoMetadata();
 }
 GeoparquetReader::GeoparquetReader(ClientContext &context, ParquetOptions parquet_options,
                                    shared_ptr<ParquetFileMetadataCache> metadata)
 	: ParquetReader(context, parquet_options, metadata) {
 	GeoparquetReader::InitializeSchema();
+	InitializeGeoMetadata();
 }
 
 inline static bool HasGeometryColumnName(const std::string& column_name) {
@@ -88,6 +93,142 @@ void GeoparquetReader::InitializeSchema() {
 	}
 }
 
+static void GetLeafColumnPaths(const vector<SchemaElement> &schema, idx_t &schema_idx, const string &prefix,
+                               vector<string> &result) {
+	auto &element = schema[schema_idx];
+	auto path = prefix.empty() ? element.name : prefix + "." + element.name;
+	if (element.__isset.num_children && element.num_children > 0) {
+		for (idx_t child_idx = 0; child_idx < (idx_t)element.num_children; child_idx++) {
+			schema_idx++;
+			GetLeafColumnPaths(schema, schema_idx, path, result);
+		}
+	} else {
+		result.push_back(path);
+	}
+}
+
+void GeoparquetReader::InitializeGeoMetadata() {
+	auto file_meta_data = GetFileMetadata();
+	for (auto &kv : file_meta_data->key_value_metadata) {
+		if (kv.key != "geo") {
+			continue;
+		}
+		auto doc = yyjson_read(kv.value.c_str(), kv.value.size(), 0);
+		if (!doc) {
+			return;
+		}
+		auto root = yyjson_doc_get_root(doc);
+		auto primary = yyjson_get_str(yyjson_obj_get(root, "primary_column"));
+		auto column = primary ? yyjson_obj_get(yyjson_obj_get(root, "columns"), primary) : nullptr;
+		if (column) {
+			primary_column = primary;
+
+			// The bbox is either [xmin, ymin, xmax, ymax] or [xmin, ymin, zmin, xmax, ymax, zmax]
+			auto bbox = yyjson_obj_get(column, "bbox");
+			auto dims = yyjson_arr_size(bbox) / 2;
+			if (dims == 2 || dims == 3) {
+				extent.minx = yyjson_get_num(yyjson_arr_get(bbox, 0));
+				extent.miny = yyjson_get_num(yyjson_arr_get(bbox, 1));
+				extent.maxx = yyjson_get_num(yyjson_arr_get(bbox, dims));
+				extent.maxy = yyjson_get_num(yyjson_arr_get(bbox, dims + 1));
+				has_extent = true;
+			}
+
+			// The bbox covering maps each bound to a (nested) column, e.g. "xmin": ["bbox", "xmin"]
+			auto covering = yyjson_obj_get(yyjson_obj_get(column, "covering"), "bbox");
+			if (covering) {
+				vector<string> leaf_paths;
+				idx_t schema_idx = 0;
+				for (idx_t child_idx = 0; child_idx < (idx_t)file_meta_data->schema[0].num_children; child_idx++) {
+					schema_idx++;
+					GetLeafColumnPaths(file_meta_data->schema, schema_idx, "", leaf_paths);
+				}
+				for (auto key : {"xmin", "ymin", "xmax", "ymax"}) {
+					auto path_arr = yyjson_obj_get(covering, key);
+					vector<string> path_parts;
+					size_t idx, max;
+					yyjson_val *part;
+					yyjson_arr_foreach(path_arr, idx, max, part) {
+						if (yyjson_is_str(part)) {
+							path_parts.emplace_back(yyjson_get_str(part));
+						}
+					}
+					auto path = StringUtil::Join(path_parts, ".");
+					auto entry = std::find(leaf_paths.begin(), leaf_paths.end(), path);
+					if (path.empty() || entry == leaf_paths.end()) {
+						break;
+					}
+					covering_columns.push_back(entry - leaf_paths.begin());
+				}
+				if (covering_columns.size() != 4) {
+					covering_columns.clear();
+				}
+			}
+		}
+		yyjson_doc_free(doc);
+		return;
+	}
+}
+
+static bool TryGetStatistic(const duckdb_parquet::format::ColumnChunk &chunk, bool get_min, double &result) {
+	if (!chunk.__isset.meta_data || !chunk.meta_data.__isset.statistics) {
+		return false;
+	}
+	auto &stats = chunk.meta_data.statistics;
+	const string *value = nullptr;
+	if (get_min) {
+		value = stats.__isset.min_value ? &stats.min_value : (stats.__isset.min ? &stats.min : nullptr);
+	} else {
+		value = stats.__isset.max_value ? &stats.max_value : (stats.__isset.max ? &stats.max : nullptr);
+	}
+	if (!value) {
+		return false;
+	}
+	if (value->size() == sizeof(double)) {
+		double d;
+		memcpy(&d, value->data(), sizeof(double));
+		result = d;
+		return true;
+	}
+	if (value->size() == sizeof(float)) {
+		float f;
+		memcpy(&f, value->data(), sizeof(float));
+		result = f;
+		return true;
+	}
+	return false;
+}
+
+bool GeoparquetReader::RowGroupMayIntersect(idx_t row_group_idx, const string &column_name,
+                                            const vector<BoundingBox> &boxes) {
+	if (column_name != primary_column) {
+		return true;
+	}
+	// A geometry has to intersect every box to pass the filters, so a single box that is missed is enough to skip
+	for (auto &bbox : boxes) {
+		if (has_extent && !extent.Intersects(bbox)) {
+			return false;
+		}
+	}
+	if (covering_columns.empty()) {
+		return true;
+	}
+	auto &row_group = GetFileMetadata()->row_groups[row_group_idx];
+	BoundingBox row_group_extent;
+	if (!TryGetStatistic(row_group.columns[covering_columns[0]], true, row_group_extent.minx) ||
+	    !TryGetStatistic(row_group.columns[covering_columns[1]], true, row_group_extent.miny) ||
+	    !TryGetStatistic(row_group.columns[covering_columns[2]], false, row_group_extent.maxx) ||
+	    !TryGetStatistic(row_group.columns[covering_columns[3]], false, row_group_extent.maxy)) {
+		return true;
+	}
+	for (auto &bbox : boxes) {
+		if (!row_group_extent.Intersects(bbox)) {
+			return false;
+		}
+	}
+	return true;
+}
+
 unique_ptr<ColumnReader> GeoparquetReader::CreateReader() {
 	auto file_meta_data = GetFileMetadata();
 	idx_t next_schema_idx = 0;
@@ -224,9 +365,8 @@ unique_ptr<ColumnReader> GeoparquetReader::CreateReaderRecursive(idx_t depth, id
 	}
 }
 
-inline string_t WKBParquetValueConversion::ConvertToSerializedGeometry(char const* data, uint32_t length, spatial::core::GeometryFactory &factory, VectorStringBuffer& buffer) {
-	auto geometry = factory.FromWKB(data, length);
-    return factory.Serialize(buffer, geometry);
+inline string_t WKBParquetValueConversion::ConvertToSerializedGeometry(char const* data, uint32_t length, VectorStringBuffer& buffer) {
+	return WKBTranscoder::Transcode(buffer, data, length);
 }
 
 string_t WKBParquetValueConversion::DictRead(ByteBuffer &dict, uint32_t &offset, ColumnReader &reader) {
@@ -235,7 +375,7 @@ string_t WKBParquetValueConversion::DictRead(ByteBuffer &dict, uint32_t &offset,
 	dict.available(str_len);
 	auto dict_str = reinterpret_cast<const char *>(dict.ptr);
 	dict.inc(str_len);
-	return WKBParquetValueConversion::ConvertToSerializedGeometry(dict_str, str_len, w_reader.factory, *w_reader.buffer);
+	return WKBParquetValueConversion::ConvertToSerializedGeometry(dict_str, str_len, *w_reader.buffer);
 }
 
 string_t WKBParquetValueConversion::PlainRead(ByteBuffer &plain_data, ColumnReader &reader) {
@@ -244,7 +384,7 @@ string_t WKBParquetValueConversion::PlainRead(ByteBuffer &plain_data, ColumnRead
 	plain_data.available(str_len);
 	auto plain_str = char_ptr_cast(plain_data.ptr);
 	plain_data.inc(str_len);
-	return WKBParquetValueConversion::ConvertToSerializedGeometry(plain_str, str_len, scr.factory,*scr.buffer);
+	return WKBParquetValueConversion::ConvertToSerializedGeometry(plain_str, str_len, *scr.buffer);
 }
 
 void WKBParquetValueConversion::PlainSkip(ByteBuffer &plain_data, ColumnReader &reader) {
@@ -265,8 +405,7 @@ void WKBColumnReader::DeltaByteArray(uint8_t *defines, idx_t num_values, parquet
 WKBColumnReader::WKBColumnReader(ParquetReader &reader, LogicalType type_p, const SchemaElement &schema_p, idx_t schema_idx_p,
 	                idx_t max_define_p, idx_t max_repeat_p)
 	    : TemplatedColumnReader<string_t, WKBParquetValueConversion>(reader, type_p, schema_p, schema_idx_p,
-	                                                                    max_define_p, max_repeat_p),
-      factory(reader.allocator)
+	                                                                    max_define_p, max_repeat_p)
 {
 	if(type_p == LogicalTypeId::VARCHAR) {
 		throw InvalidInputException("WKBColumnReader can only read WKB as BLOBs");
@@ -13,6 +13,7 @@
 #include "parquet_writer.hpp"
 #include "spatial/common.hpp"
 #include "spatial/core/functions/table.hpp"
+#include "spatial/core/functions/common.hpp"
 #include "spatial/core/functions/geoparquet_reader.hpp"
 #include "spatial/core/types.hpp"
 #include "zstd_file_system.hpp"
@@ -72,6 +73,11 @@ struct BindData : public TableFunctionData {
 	ParquetOptions parquet_options;
 	MultiFileReaderBindData reader_bind;
 
+	// The bounding box pushed down from spatial predicates on a geometry column, used to skip row groups
+	bool has_spatial_filter = false;
+	string spatial_filter_column;
+	vector<BoundingBox> spatial_filter_boxes;
+
 	void Initialize(shared_ptr<GeoparquetReader> reader) {
 		initial_reader = std::move(reader);
 		initial_file_cardinality = initial_reader->NumRows();
@@ -155,6 +161,14 @@ static bool ParallelStateNext(ClientContext &context, const BindData &bind_data,
 		if (parallel_state.file_states[parallel_state.file_index] == ParquetFileState::OPEN) {
 			if (parallel_state.row_group_index <
 			    parallel_state.readers[parallel_state.file_index]->NumRowGroups()) {
+				if (bind_data.has_spatial_filter &&
+				    !parallel_state.readers[parallel_state.file_index]->RowGroupMayIntersect(
+				        parallel_state.row_group_index, bind_data.spatial_filter_column,
+				        bind_data.spatial_filter_boxes)) {
+					// No geometry in this rowgroup can pass the spatial filter, skip it
+					parallel_state.row_group_index++;
+					continue;
+				}
 				// The current reader has rowgroups left to be scanned
 				scan_data.reader = parallel_state.readers[parallel_state.file_index];
 				vector<idx_t> group_indexes {parallel_state.row_group_index};
@@ -395,6 +409,34 @@ static void Execute(ClientContext &context, TableFunctionInput &input, DataChunk
 	} while (true);
 };
 
+static void PushdownComplexFilter(ClientContext &context, LogicalGet &get, FunctionData *bind_data_p,
+                                  vector<unique_ptr<Expression>> &filters) {
+	auto &bind_data = bind_data_p->Cast<BindData>();
+
+	// Find the geometry column to prune on, preferably the primary column declared in the metadata
+	string primary_column;
+	if (bind_data.initial_reader) {
+		primary_column = bind_data.initial_reader->primary_column;
+	}
+	for (idx_t col_idx = 0; col_idx < bind_data.names.size(); col_idx++) {
+		if (bind_data.types[col_idx] != GeoTypes::GEOMETRY()) {
+			continue;
+		}
+		if (!primary_column.empty() && bind_data.names[col_idx] != primary_column) {
+			continue;
+		}
+		// The filters are kept, we only use them to skip rowgroups
+		vector<BoundingBox> boxes;
+		SpatialFilterPushdown::GetFilterBoxes(get, filters, col_idx, false, boxes);
+		if (!boxes.empty()) {
+			bind_data.has_spatial_filter = true;
+			bind_data.spatial_filter_column = bind_data.names[col_idx];
+			bind_data.spatial_filter_boxes = std::move(boxes);
+		}
+		return;
+	}
+}
+
 static double Progress(ClientContext &context, const FunctionData *bind_data,
                        const GlobalTableFunctionState *global_state) {
     return 0;
@@ -435,6 +477,7 @@ void CoreTableFunctions::RegisterGeoparquetTableFunction(duckdb::DatabaseInstanc
 	);
 	read.get_batch_index = geoparquet::GetBatchIndex;
 	read.table_scan_progress = geoparquet::Progress;
+	read.pushdown_complex_filter = geoparquet::PushdownComplexFilter;
 
 	ExtensionUtil::RegisterFunction(db, read);
 
@@ -4,13 +4,25 @@
 #include "duckdb/parser/expression/constant_expression.hpp"
 #include "duckdb/parser/expression/function_expression.hpp"
 #include "duckdb/parser/tableref/table_function_ref.hpp"
+#include "duckdb/planner/expression/bound_cast_expression.hpp"
+#include "duckdb/planner/expression/bound_columnref_expression.hpp"
+#include "duckdb/planner/expression/bound_comparison_expression.hpp"
+#include "duckdb/planner/expression/bound_conjunction_expression.hpp"
+#include "duckdb/planner/expression/bound_constant_expression.hpp"
+#include "duckdb/planner/expression/bound_function_expression.hpp"
+#include "duckdb/planner/expression/bound_operator_expression.hpp"
+#include "duckdb/planner/operator/logical_get.hpp"
 
 #include "spatial/common.hpp"
 #include "spatial/core/functions/table.hpp"
 #include "spatial/core/types.hpp"
+#include "spatial/core/geometry/geometry.hpp"
+#include "spatial/core/geometry/geometry_factory.hpp"
 
+#include "lz4.hpp"
 #include "protozero/pbf_reader.hpp"
 #include "zlib.h"
+#include "zstd.h"
 
 namespace spatial {
 
@@ -25,12 +37,37 @@ static int32_t ReadInt32BigEndian(data_ptr_t ptr) {
 	return (ptr[0] << 24) | (ptr[1] << 16) | (ptr[2] << 8) | ptr[3];
 }
 
+// The columns of the table function
+struct OsmColumn {
+	static constexpr idx_t KIND = 0;
+	static constexpr idx_t ID = 1;
+	static constexpr idx_t TAGS = 2;
+	static constexpr idx_t REFS = 3;
+	static constexpr idx_t LAT = 4;
+	static constexpr idx_t LON = 5;
+	static constexpr idx_t REF_ROLES = 6;
+	static constexpr idx_t REF_TYPES = 7;
+	// Only present when reading with geometry = true
+	static constexpr idx_t GEOMETRY = 8;
+	static constexpr idx_t COUNT = 9;
+};
+
 //------------------------------------------------------------------------------
 // OSM Table Function
 //------------------------------------------------------------------------------
 
+// The kinds of entities in the kind column, changesets are not read
+static constexpr idx_t OSM_KIND_COUNT = 3;
+
 struct BindData : TableFunctionData {
 	string file_name;
+	// Whether to assemble the geometries of the entities into a geometry column
+	bool geometry = false;
+
+	// The kinds of entities that can pass the filters of the query, indexed by their value in the kind column
+	bool kinds[OSM_KIND_COUNT] = {true, true, true};
+	// The tag keys that an entity must have to pass the filters of the query
+	vector<string> required_tag_keys;
 
 	BindData(string file_name) : file_name(file_name) {
 	}
@@ -89,11 +126,198 @@ static unique_ptr<FunctionData> Bind(ClientContext &context, TableFunctionBindIn
 		throw PermissionException("Scanning OSM files is disabled through configuration");
 	}
 
+	bool geometry = false;
+	for (auto &kv : input.named_parameters) {
+		auto loption = StringUtil::Lower(kv.first);
+		if (loption == "geometry") {
+			geometry = BooleanValue::Get(kv.second);
+		}
+	}
+	if (geometry) {
+		return_types.push_back(GeoTypes::GEOMETRY());
+		names.push_back("geometry");
+	}
+
 	auto file_name = StringValue::Get(input.inputs[0]);
 	auto result = make_uniq<BindData>(file_name);
+	result->geometry = geometry;
 	return std::move(result);
 }
 
+//------------------------------------------------------------------------------
+// Filter Pushdown
+//------------------------------------------------------------------------------
+static bool IsColumnRef(const Expression &expr, LogicalGet &get, idx_t column_idx) {
+	auto ref = &expr;
+	// Comparing the kind enum with strings casts the column
+	while (ref->type == ExpressionType::OPERATOR_CAST) {
+		ref = ref->Cast<BoundCastExpression>().child.get();
+	}
+	if (ref->type != ExpressionType::BOUND_COLUMN_REF) {
+		return false;
+	}
+	auto &colref = ref->Cast<BoundColumnRefExpression>();
+	return colref.binding.table_index == get.table_index && colref.binding.column_index < get.column_ids.size() &&
+	       get.column_ids[colref.binding.column_index] == column_idx;
+}
+
+static void AddKind(const Value &value, bool kinds[OSM_KIND_COUNT]) {
+	// Nothing compares equal to NULL, or to a kind that is not read
+	if (value.IsNull()) {
+		return;
+	}
+	auto name = value.ToString();
+	if (name == "node") {
+		kinds[0] = true;
+	} else if (name == "way") {
+		kinds[1] = true;
+	} else if (name == "relation") {
+		kinds[2] = true;
+	}
+}
+
+// Returns true if the filter only passes entities of the kinds it sets
+static bool TryGetKindFilter(const Expression &expr, LogicalGet &get, bool kinds[OSM_KIND_COUNT]) {
+	for (idx_t i = 0; i < OSM_KIND_COUNT; i++) {
+		kinds[i] = false;
+	}
+	switch (expr.type) {
+	case ExpressionType::COMPARE_EQUAL: {
+		auto &comparison = expr.Cast<BoundComparisonExpression>();
+		auto column = comparison.left.get();
+		auto constant = comparison.right.get();
+		if (column->type == ExpressionType::VALUE_CONSTANT) {
+			std::swap(column, constant);
+		}
+		if (!IsColumnRef(*column, get, OsmColumn::KIND) || constant->type != ExpressionType::VALUE_CONSTANT) {
+			return false;
+		}
+		AddKind(constant->Cast<BoundConstantExpression>().value, kinds);
+		return true;
+	}
+	case ExpressionType::COMPARE_IN: {
+		auto &in = expr.Cast<BoundOperatorExpression>();
+		if (!IsColumnRef(*in.children[0], get, OsmColumn::KIND)) {
+			return false;
+		}
+		for (idx_t i = 1; i < in.children.size(); i++) {
+			if (in.children[i]->type != ExpressionType::VALUE_CONSTANT) {
+				return false;
+			}
+			AddKind(in.children[i]->Cast<BoundConstantExpression>().value, kinds);
+		}
+		return true;
+	}
+	case ExpressionType::CONJUNCTION_OR: {
+		auto &conjunction = expr.Cast<BoundConjunctionExpression>();
+		for (auto &child : conjunction.children) {
+			bool child_kinds[OSM_KIND_COUNT];
+			if (!TryGetKindFilter(*child, get, child_kinds)) {
+				return false;
+			}
+			for (idx_t i = 0; i < OSM_KIND_COUNT; i++) {
+				kinds[i] = kinds[i] || child_kinds[i];
+			}
+		}
+		return true;
+	}
+	default:
+		return false;
+	}
+}
+
+// Returns true if the expression is a tag value, tags['key'][1]. Subscripting a MAP returns a list of the values
+// of the key, which is empty if the tags do not contain the key, so the value is NULL for entities without it.
+static bool TryGetTagValueKey(const Expression &expr, LogicalGet &get, string &key) {
+	auto value = &expr;
+	while (value->type == ExpressionType::OPERATOR_CAST) {
+		value = value->Cast<BoundCastExpression>().child.get();
+	}
+	if (value->type != ExpressionType::BOUND_FUNCTION) {
+		return false;
+	}
+	auto &list_extract = value->Cast<BoundFunctionExpression>();
+	auto &list_name = list_extract.function.name;
+	if (list_extract.children.size() != 2 || (list_name != "array_extract" && list_name != "list_extract" &&
+	                                          list_name != "list_element")) {
+		return false;
+	}
+	auto &map = *list_extract.children[0];
+	if (map.type != ExpressionType::BOUND_FUNCTION) {
+		return false;
+	}
+	auto &map_extract = map.Cast<BoundFunctionExpression>();
+	auto &map_name = map_extract.function.name;
+	if (map_extract.children.size() != 2 || (map_name != "map_extract" && map_name != "element_at") ||
+	    !IsColumnRef(*map_extract.children[0], get, OsmColumn::TAGS) ||
+	    map_extract.children[1]->type != ExpressionType::VALUE_CONSTANT) {
+		return false;
+	}
+	auto &key_value = map_extract.children[1]->Cast<BoundConstantExpression>().value;
+	if (key_value.IsNull() || key_value.type().id() != LogicalTypeId::VARCHAR) {
+		return false;
+	}
+	key = StringValue::Get(key_value);
+	return true;
+}
+
+// Returns true if the filter can only pass entities that have the tag key it sets
+static bool TryGetRequiredTagKey(const Expression &expr, LogicalGet &get, string &key) {
+	switch (expr.GetExpressionClass()) {
+	case ExpressionClass::BOUND_COMPARISON: {
+		// Comparisons with NULL are NULL, except for IS [NOT] DISTINCT FROM
+		if (expr.type == ExpressionType::COMPARE_DISTINCT_FROM ||
+		    expr.type == ExpressionType::COMPARE_NOT_DISTINCT_FROM) {
+			return false;
+		}
+		auto &comparison = expr.Cast<BoundComparisonExpression>();
+		return TryGetTagValueKey(*comparison.left, get, key) || TryGetTagValueKey(*comparison.right, get, key);
+	}
+	case ExpressionClass::BOUND_OPERATOR: {
+		auto &op = expr.Cast<BoundOperatorExpression>();
+		return expr.type == ExpressionType::OPERATOR_IS_NOT_NULL && TryGetTagValueKey(*op.children[0], get, key);
+	}
+	case ExpressionClass::BOUND_FUNCTION: {
+		// e.g. LIKE or prefix, which return NULL if any of their arguments is NULL
+		auto &func = expr.Cast<BoundFunctionExpression>();
+		if (func.function.null_handling != FunctionNullHandling::DEFAULT_NULL_HANDLING) {
+			return false;
+		}
+		for (auto &child : func.children) {
+			if (TryGetTagValueKey(*child, get, key)) {
+				return true;
+			}
+		}
+		return false;
+	}
+	default:
+		return false;
+	}
+}
+
+// The filters are only inspected, and left in place to be evaluated on the output.
+// Groups of entities of the wrong kind, and blocks and entities without the required tag keys, are skipped.
+static void PushdownComplexFilter(ClientContext &context, LogicalGet &get, FunctionData *bind_data_p,
+                                  vector<unique_ptr<Expression>> &filters) {
+	auto &data = bind_data_p->Cast<BindData>();
+	for (auto &filter : filters) {
+		bool kinds[OSM_KIND_COUNT];
+		if (TryGetKindFilter(*filter, get, kinds)) {
+			for (idx_t i = 0; i < OSM_KIND_COUNT; i++) {
+				data.kinds[i] = data.kinds[i] && kinds[i];
+			}
+			continue;
+		}
+		string key;
+		if (TryGetRequiredTagKey(*filter, get, key)) {
+			auto &keys = data.required_tag_keys;
+			if (std::find(keys.begin(), keys.end(), key) == keys.end()) {
+				keys.push_back(key);
+			}
+		}
+	}
+}
+
 enum class FileBlockType { Header, Data };
 
 struct OsmBlob {
@@ -118,39 +342,266 @@ struct FileBlock {
 	}
 };
 
-static unique_ptr<FileBlock> DecompressBlob(ClientContext &context, OsmBlob &blob) {
-
-	auto &buffer_manager = BufferManager::GetBufferManager(context);
-	pz::pbf_reader reader((const char *)blob.data.get(), blob.size);
-
-	// TODO: For now we assume they are all zlib compressed
-	reader.next(2);
-	auto blob_uncompressed_size = reader.get_int32();
-	reader.next(3);
-	auto view = reader.get_view();
-
-	auto uncompressed_handle = buffer_manager.GetBufferAllocator().Allocate(blob_uncompressed_size);
-	auto uncompressed_ptr = uncompressed_handle.get();
-
+static void InflateZlib(const pz::data_view &view, data_ptr_t out, int32_t out_size) {
 	z_stream zstream = {};
 	zstream.avail_in = view.size();
 	zstream.next_in = (Bytef *)view.data();
-	zstream.avail_out = blob_uncompressed_size;
-	zstream.next_out = (Bytef *)uncompressed_ptr;
+	zstream.avail_out = out_size;
+	zstream.next_out = (Bytef *)out;
 	auto ok = inflateInit(&zstream);
 	if (ok != Z_OK) {
 		throw ParserException("Failed to initialize zlib");
 	}
 	ok = inflate(&zstream, Z_FINISH);
-	if (ok != Z_STREAM_END) {
+	auto total_out = zstream.total_out;
+	inflateEnd(&zstream);
+	if (ok != Z_STREAM_END || total_out != (uLong)out_size) {
 		throw ParserException("Failed to inflate zlib");
 	}
-	ok = inflateEnd(&zstream);
-	// Cool, we have the uncompressed data
+}
+
+static void DecompressZstd(const pz::data_view &view, data_ptr_t out, int32_t out_size) {
+	auto result = duckdb_zstd::ZSTD_decompress(out, out_size, view.data(), view.size());
+	if (duckdb_zstd::ZSTD_isError(result) || result != (size_t)out_size) {
+		throw ParserException("Failed to decompress zstd");
+	}
+}
+
+static void DecompressLz4(const pz::data_view &view, data_ptr_t out, int32_t out_size) {
+	// The blobs contain a single LZ4 block, not an LZ4 frame
+	auto result = duckdb_lz4::LZ4_decompress_safe(view.data(), (char *)out, (int)view.size(), out_size);
+	if (result != out_size) {
+		throw ParserException("Failed to decompress lz4");
+	}
+}
+
+static unique_ptr<FileBlock> DecompressBlob(ClientContext &context, OsmBlob &blob) {
+
+	auto &buffer_manager = BufferManager::GetBufferManager(context);
+	pz::pbf_reader reader((const char *)blob.data.get(), blob.size);
+
+	// A blob holds its data in exactly one of the encodings, and the uncompressed size if it is compressed
+	int32_t raw_size = -1;
+	uint32_t encoding = 0;
+	pz::data_view view;
+	while (reader.next()) {
+		switch (reader.tag()) {
+		case 2: // raw_size
+			raw_size = reader.get_int32();
+			break;
+		case 1: // raw
+		case 3: // zlib_data
+		case 4: // lzma_data
+		case 5: // OBSOLETE_bzip2_data
+		case 6: // lz4_data
+		case 7: // zstd_data
+			encoding = reader.tag();
+			view = reader.get_view();
+			break;
+		default:
+			reader.skip();
+		}
+	}
+
+	if (encoding == 1) {
+		auto size = view.size();
+		auto data = buffer_manager.GetBufferAllocator().Allocate(size);
+		memcpy(data.get(), view.data(), size);
+		return make_uniq<FileBlock>(blob.type, std::move(data), size, blob.blob_idx);
+	}
+
+	if (encoding == 0) {
+		throw ParserException("Blob does not contain any data");
+	}
+	if (raw_size < 0) {
+		throw ParserException("Compressed blob is missing its uncompressed size");
+	}
+
+	auto uncompressed_handle = buffer_manager.GetBufferAllocator().Allocate(raw_size);
+	auto uncompressed_ptr = uncompressed_handle.get();
+
+	switch (encoding) {
+	case 3:
+		InflateZlib(view, uncompressed_ptr, raw_size);
+		break;
+	case 6:
+		DecompressLz4(view, uncompressed_ptr, raw_size);
+		break;
+	case 7:
+		DecompressZstd(view, uncompressed_ptr, raw_size);
+		break;
+	case 4:
+		throw NotImplementedException("LZMA compressed blobs are not supported");
+	default:
+		throw NotImplementedException("bzip2 compressed blobs are not supported");
+	}
 
-	return make_uniq<FileBlock>(blob.type, std::move(uncompressed_handle), blob_uncompressed_size, blob.blob_idx);
+	return make_uniq<FileBlock>(blob.type, std::move(uncompressed_handle), raw_size, blob.blob_idx);
 };
 
+//------------------------------------------------------------------------------
+// Geometry Index
+//------------------------------------------------------------------------------
+// The coordinates in the geometries are converted from nanodegrees by division, rather than by multiplying with
+// the (inexact) reciprocal, so that locations on the fixed point grid map to the closest double.
+static constexpr double OSM_NANODEGREES = 1000000000.0;
+// The locations of the nodes are stored as fixed point numbers in units of 100 nanodegrees
+static constexpr double OSM_LOCATION_SCALE = 10000000.0;
+
+// The locations of the nodes, sorted by id. The entries are stored in blocks allocated through the buffer manager,
+// so that the store can be spilled to the temporary directory when it does not fit in memory.
+class NodeLocationStore {
+	struct Entry {
+		int64_t id;
+		int32_t x;
+		int32_t y;
+	};
+
+	static constexpr idx_t ENTRIES_PER_BLOCK = Storage::BLOCK_SIZE / sizeof(Entry);
+
+	BufferManager &buffer_manager;
+	vector<shared_ptr<BlockHandle>> blocks;
+	// The id of the first entry in each block
+	vector<int64_t> block_first_ids;
+	// The number of entries in the last block
+	idx_t last_block_count;
+	BufferHandle append_handle;
+
+public:
+	explicit NodeLocationStore(BufferManager &buffer_manager) : buffer_manager(buffer_manager), last_block_count(0) {
+	}
+
+	void Append(int64_t id, int64_t lat_nano, int64_t lon_nano) {
+		if (!block_first_ids.empty() && id <= LastId()) {
+			throw InvalidInputException(
+			    "ST_ReadOSM with geometry = true requires the nodes in the file to be sorted by id");
+		}
+		if (blocks.empty() || last_block_count == ENTRIES_PER_BLOCK) {
+			shared_ptr<BlockHandle> block;
+			append_handle = buffer_manager.Allocate(Storage::BLOCK_SIZE, false, &block);
+			blocks.push_back(std::move(block));
+			block_first_ids.push_back(id);
+			last_block_count = 0;
+		}
+		auto entries = reinterpret_cast<Entry *>(append_handle.Ptr());
+		auto &entry = entries[last_block_count++];
+		entry.id = id;
+		entry.x = (int32_t)std::llround((double)lon_nano / 100);
+		entry.y = (int32_t)std::llround((double)lat_nano / 100);
+	}
+
+	// Unpin the block that was appended to last, all blocks can be evicted from now on
+	void Finalize() {
+		append_handle.Destroy();
+	}
+
+	// Looks up the locations of the nodes in the store. Keeps the last block it looked in pinned, as consecutive
+	// lookups (the nodes of a way) usually have ids that are close together.
+	class Reader {
+		NodeLocationStore &store;
+		idx_t pinned_block;
+		BufferHandle handle;
+
+	public:
+		explicit Reader(NodeLocationStore &store) : store(store), pinned_block(DConstants::INVALID_INDEX) {
+		}
+
+		bool TryGet(int64_t id, Vertex &vertex) {
+			auto &first_ids = store.block_first_ids;
+			auto next_block = std::upper_bound(first_ids.begin(), first_ids.end(), id);
+			if (next_block == first_ids.begin()) {
+				return false;
+			}
+			auto block_idx = (idx_t)(next_block - first_ids.begin()) - 1;
+			if (block_idx != pinned_block) {
+				handle = store.buffer_manager.Pin(store.blocks[block_idx]);
+				pinned_block = block_idx;
+			}
+			auto entries = reinterpret_cast<const Entry *>(handle.Ptr());
+			idx_t count = ENTRIES_PER_BLOCK;
+			if (block_idx + 1 == store.blocks.size()) {
+				count = store.last_block_count;
+			}
+			auto entry = std::lower_bound(entries, entries + count, id,
+			                              [](const Entry &entry, int64_t id) { return entry.id < id; });
+			if (entry == entries + count || entry->id != id) {
+				return false;
+			}
+			vertex = Vertex(entry->x / OSM_LOCATION_SCALE, entry->y / OSM_LOCATION_SCALE);
+			return true;
+		}
+	};
+
+private:
+	int64_t LastId() const {
+		auto entries = reinterpret_cast<const Entry *>(append_handle.Ptr());
+		return entries[last_block_count - 1].id;
+	}
+};
+
+struct OsmGeometryIndex {
+	NodeLocationStore nodes;
+	// The node refs of the ways that are members of multipolygon relations
+	unordered_map<int64_t, vector<int64_t>> member_ways;
+
+	explicit OsmGeometryIndex(BufferManager &buffer_manager) : nodes(buffer_manager) {
+	}
+};
+
+// Returns the id of the string in the string table, or 0 (the empty string) if it is not in the table
+static uint32_t FindString(const vector<string> &string_table, const string &str) {
+	auto entry = std::find(string_table.begin(), string_table.end(), str);
+	return entry == string_table.end() ? 0 : (uint32_t)(entry - string_table.begin());
+}
+
+// The string table and coordinate transformation of a block
+struct OsmBlockInfo {
+	vector<string> string_table;
+	int32_t granularity = 100;
+	int64_t lat_offset = 0;
+	int64_t lon_offset = 0;
+
+	explicit OsmBlockInfo(const FileBlock &block) {
+		pz::pbf_reader reader((const char *)block.data.get(), block.size);
+		while (reader.next()) {
+			switch (reader.tag()) {
+			case 1: {
+				auto string_table_reader = reader.get_message();
+				while (string_table_reader.next(1)) {
+					string_table.push_back(string_table_reader.get_string());
+				}
+			} break;
+			case 17:
+				granularity = reader.get_int32();
+				break;
+			case 19:
+				lat_offset = reader.get_int64();
+				break;
+			case 20:
+				lon_offset = reader.get_int64();
+				break;
+			default:
+				reader.skip();
+			}
+		}
+	}
+};
+
+static bool HasTag(const pz::iterator_range<pz::const_varint_iterator<uint32_t>> &key_iter,
+                   const pz::iterator_range<pz::const_varint_iterator<uint32_t>> &val_iter, uint32_t key,
+                   uint32_t val) {
+	if (key == 0 || val == 0) {
+		return false;
+	}
+	auto vals = val_iter.begin();
+	for (auto keys = key_iter.begin(); keys != key_iter.end() && vals != val_iter.end(); ++keys, ++vals) {
+		if (*keys == key && *vals == val) {
+			return true;
+		}
+	}
+	return false;
+}
+
 class GlobalState : public GlobalTableFunctionState {
 	mutex lock;
 	unique_ptr<FileHandle> handle;
@@ -161,6 +612,23 @@ class GlobalState : public GlobalTableFunctionState {
 	atomic<idx_t> bytes_read;
 	idx_t max_threads;
 
+public:
+	// The node locations and member ways used to assemble the geometries, if the geometry column is projected
+	unique_ptr<OsmGeometryIndex> geometry_index;
+
+private:
+	// Most BlobHeaders are only a few bytes long, so the header length and the header are read at once
+	static constexpr idx_t HEADER_READ_SIZE = 64;
+	// The maximum size of a BlobHeader according to the format specification
+	static constexpr int32_t MAX_HEADER_SIZE = 64 * 1024;
+
+	struct BlobLocation {
+		FileBlockType type;
+		idx_t offset;
+		idx_t size;
+		idx_t blob_idx;
+	};
+
 public:
 	GlobalState(unique_ptr<FileHandle> handle, idx_t file_size, idx_t max_threads)
 	    : handle(std::move(handle)), file_size(file_size), offset(0), done(false), blob_index(0), bytes_read(0),
@@ -175,63 +643,336 @@ public:
 		return max_threads;
 	}
 
+	// Reads the next blob with the shared handle, only if no other thread reads from this state
 	unique_ptr<OsmBlob> GetNextBlob(ClientContext &context) {
+		return GetNextBlob(context, *handle);
+	}
+
+	// Reads the next blob with the given handle. The blob is read outside of the lock, so that the threads read
+	// and decompress their blobs in parallel. Each thread has to pass its own handle, as not every file system
+	// (e.g. httpfs) supports concurrent reads through a single handle.
+	unique_ptr<OsmBlob> GetNextBlob(ClientContext &context, FileHandle &blob_handle) {
+		BlobLocation location;
+		if (!ClaimNextBlob(location)) {
+			return nullptr;
+		}
+
+		auto &buffer_manager = BufferManager::GetBufferManager(context);
+		auto blob_buffer = buffer_manager.GetBufferAllocator().Allocate(location.size);
+		blob_handle.Read(blob_buffer.get(), location.size, location.offset);
+		bytes_read += location.size;
+
+		return make_uniq<OsmBlob>(location.type, std::move(blob_buffer), location.size, location.blob_idx);
+	}
+
+private:
+	// Find the location of the next blob in the file. Only the small headers in front of the blobs are read
+	// while holding the lock, the position of the next blob is known as soon as its header has been parsed.
+	bool ClaimNextBlob(BlobLocation &location) {
 		lock_guard<mutex> glock(lock);
 
 		if (done) {
-			return nullptr;
+			return false;
 		}
 		if (offset >= file_size) {
 			done = true;
-			return nullptr;
+			return false;
 		}
 
-		auto &buffer_manager = BufferManager::GetBufferManager(context);
-
 		// The format is a repeating sequence of:
 		//    int4: length of the BlobHeader message in network byte order
 		//    serialized BlobHeader message
 		//    serialized Blob message (size is given in the header)
 
-		// Read the length of the BlobHeader
-		int32_t header_length_be = 0;
-		handle->Read((data_ptr_t)&header_length_be, sizeof(int32_t), offset);
-		offset += sizeof(int32_t);
-		int32_t header_length = ReadInt32BigEndian((data_ptr_t)&header_length_be);
+		// Read the length of the BlobHeader, and (usually) the BlobHeader itself
+		data_t header_buffer[HEADER_READ_SIZE];
+		auto read_size = MinValue<idx_t>(HEADER_READ_SIZE, file_size - offset);
+		if (read_size < sizeof(int32_t)) {
+			throw ParserException("Unexpected end of file while reading BlobHeader");
+		}
+		handle->Read(header_buffer, read_size, offset);
+		int32_t header_length = ReadInt32BigEndian(header_buffer);
+		if (header_length < 0 || header_length > MAX_HEADER_SIZE) {
+			throw ParserException("Invalid BlobHeader length %d", header_length);
+		}
+		if (offset + sizeof(int32_t) + header_length > file_size) {
+			throw ParserException("Unexpected end of file while reading BlobHeader");
+		}
 
-		// Read the BlobHeader
-		auto header_buffer = buffer_manager.GetBufferAllocator().Allocate(header_length);
-		handle->Read(header_buffer.get(), header_length, offset);
+		auto header_ptr = (const char *)header_buffer + sizeof(int32_t);
+		vector<data_t> large_header;
+		if (sizeof(int32_t) + header_length > read_size) {
+			large_header.resize(header_length);
+			handle->Read(large_header.data(), header_length, offset + sizeof(int32_t));
+			header_ptr = (const char *)large_header.data();
+		}
 
-		pz::pbf_reader reader((const char *)header_buffer.get(), header_length);
+		pz::pbf_reader reader(header_ptr, header_length);
+		string type_str;
+		int32_t blob_length = -1;
+		while (reader.next()) {
+			switch (reader.tag()) {
+			// 1 - type of the blob
+			case 1:
+				type_str = reader.get_string();
+				break;
+			// 3 - size of the next blob
+			case 3:
+				blob_length = reader.get_int32();
+				break;
+			default:
+				reader.skip();
+			}
+		}
 
-		// 1 - type of the blob
-		reader.next(1);
-		auto type_str = reader.get_string();
-		FileBlockType type;
 		if (type_str == "OSMHeader") {
-			type = FileBlockType::Header;
+			location.type = FileBlockType::Header;
 		} else if (type_str == "OSMData") {
-			type = FileBlockType::Data;
+			location.type = FileBlockType::Data;
 		} else {
 			throw ParserException("Unexpected fileblock type in Blob");
 		}
-		// 3 - size of the next blob
-		reader.next(3);
-		auto blob_length = reader.get_int32(); // size of the next blob
 
-		offset += header_length;
+		location.offset = offset + sizeof(int32_t) + header_length;
+		if (blob_length < 0 || location.offset + blob_length > file_size) {
+			throw ParserException("Unexpected end of file while reading Blob");
+		}
+		location.size = blob_length;
+		location.blob_idx = blob_index++;
 
-		// Read the Blob
-		auto blob_buffer = buffer_manager.GetBufferAllocator().Allocate(blob_length);
-		handle->Read(blob_buffer.get(), blob_length, offset);
+		offset = location.offset + location.size;
+		bytes_read += sizeof(int32_t) + header_length;
+		return true;
+	}
+};
 
-		offset += blob_length;
-		bytes_read = offset;
+// Store the node locations, and collect the ways that are members of multipolygon relations
+static void IndexNodesAndRelations(const FileBlock &block, OsmGeometryIndex &index,
+                                   unordered_set<int64_t> &member_way_ids) {
+	OsmBlockInfo info(block);
+	auto type_key = FindString(info.string_table, "type");
+	auto multipolygon_value = FindString(info.string_table, "multipolygon");
+
+	pz::pbf_reader block_reader((const char *)block.data.get(), block.size);
+	while (block_reader.next(2)) {
+		auto group_reader = block_reader.get_message();
+		while (group_reader.next()) {
+			switch (group_reader.tag()) {
+			case 1: { // Node
+				auto node = group_reader.get_message();
+				int64_t id = 0;
+				int64_t lat = 0;
+				int64_t lon = 0;
+				while (node.next()) {
+					switch (node.tag()) {
+					case 1:
+						id = node.get_sint64();
+						break;
+					case 8:
+						lat = node.get_sint64();
+						break;
+					case 9:
+						lon = node.get_sint64();
+						break;
+					default:
+						node.skip();
+					}
+				}
+				index.nodes.Append(id, info.lat_offset + info.granularity * lat,
+				                   info.lon_offset + info.granularity * lon);
+			} break;
+			case 2: { // Dense nodes
+				auto dense_nodes = group_reader.get_message();
+				pz::iterator_range<pz::const_svarint_iterator<int64_t>> id_iter;
+				pz::iterator_range<pz::const_svarint_iterator<int64_t>> lat_iter;
+				pz::iterator_range<pz::const_svarint_iterator<int64_t>> lon_iter;
+				while (dense_nodes.next()) {
+					switch (dense_nodes.tag()) {
+					case 1:
+						id_iter = dense_nodes.get_packed_sint64();
+						break;
+					case 8:
+						lat_iter = dense_nodes.get_packed_sint64();
+						break;
+					case 9:
+						lon_iter = dense_nodes.get_packed_sint64();
+						break;
+					default:
+						dense_nodes.skip();
+					}
+				}
+				// All three are delta encoded
+				int64_t id = 0;
+				int64_t lat = 0;
+				int64_t lon = 0;
+				auto lats = lat_iter.begin();
+				auto lons = lon_iter.begin();
+				for (auto ids = id_iter.begin(); ids != id_iter.end() && lats != lat_iter.end() && lons != lon_iter.end();
+				     ++ids, ++lats, ++lons) {
+					id += *ids;
+					lat += *lats;
+					lon += *lons;
+					index.nodes.Append(id, info.lat_offset + info.granularity * lat,
+					                   info.lon_offset + info.granularity * lon);
+				}
+			} break;
+			case 4: { // Relation
+				auto relation = group_reader.get_message();
+				pz::iterator_range<pz::const_varint_iterator<uint32_t>> key_iter;
+				pz::iterator_range<pz::const_varint_iterator<uint32_t>> val_iter;
+				pz::iterator_range<pz::const_svarint_iterator<int64_t>> ref_iter;
+				pz::iterator_range<pz::const_varint_iterator<int32_t>> type_iter;
+				while (relation.next()) {
+					switch (relation.tag()) {
+					case 2:
+						key_iter = relation.get_packed_uint32();
+						break;
+					case 3:
+						val_iter = relation.get_packed_uint32();
+						break;
+					case 9:
+						ref_iter = relation.get_packed_sint64();
+						break;
+					case 10:
+						type_iter = relation.get_packed_int32();
+						break;
+					default:
+						relation.skip();
+					}
+				}
+				if (!HasTag(key_iter, val_iter, type_key, multipolygon_value)) {
+					break;
+				}
+				int64_t ref = 0;
+				auto types = type_iter.begin();
+				for (auto refs = ref_iter.begin(); refs != ref_iter.end() && types != type_iter.end(); ++refs, ++types) {
+					ref += *refs;
+					if (*types == 1) {
+						member_way_ids.insert(ref);
+					}
+				}
+			} break;
+			default:
+				group_reader.skip();
+			}
+		}
+	}
+}
 
-		return make_uniq<OsmBlob>(type, std::move(blob_buffer), blob_length, blob_index++);
+// Store the node refs of the ways that are members of multipolygon relations
+static void IndexMemberWays(const FileBlock &block, OsmGeometryIndex &index,
+                            const unordered_set<int64_t> &member_way_ids) {
+	pz::pbf_reader block_reader((const char *)block.data.get(), block.size);
+	while (block_reader.next(2)) {
+		auto group_reader = block_reader.get_message();
+		while (group_reader.next()) {
+			if (group_reader.tag() != 3) {
+				group_reader.skip();
+				continue;
+			}
+			auto way = group_reader.get_message();
+			int64_t id = 0;
+			pz::iterator_range<pz::const_svarint_iterator<int64_t>> ref_iter;
+			while (way.next()) {
+				switch (way.tag()) {
+				case 1:
+					id = way.get_int64();
+					break;
+				case 8:
+					ref_iter = way.get_packed_sint64();
+					break;
+				default:
+					way.skip();
+				}
+			}
+			if (member_way_ids.find(id) == member_way_ids.end()) {
+				continue;
+			}
+			auto &refs = index.member_ways[id];
+			int64_t ref = 0;
+			for (auto delta : ref_iter) {
+				ref += delta;
+				refs.push_back(ref);
+			}
+		}
 	}
-};
+}
+
+// Scans the file once to store the locations of all nodes, and once more to store the node refs of the ways that
+// make up multipolygons, if the file contains any. The geometries are then assembled during the (parallel) scan.
+static unique_ptr<OsmGeometryIndex> BuildGeometryIndex(ClientContext &context, const string &file_name) {
+	auto &fs = FileSystem::GetFileSystem(context);
+	auto index = make_uniq<OsmGeometryIndex>(BufferManager::GetBufferManager(context));
+
+	unordered_set<int64_t> member_way_ids;
+	{
+		auto handle = fs.OpenFile(file_name, FileFlags::FILE_FLAGS_READ, FileLockType::READ_LOCK);
+		auto file_size = handle->GetFileSize();
+		GlobalState pass(std::move(handle), file_size, 1);
+		for (auto blob = pass.GetNextBlob(context); blob; blob = pass.GetNextBlob(context)) {
+			if (blob->type == FileBlockType::Data) {
+				auto block = DecompressBlob(context, *blob);
+				IndexNodesAndRelations(*block, *index, member_way_ids);
+			}
+		}
+	}
+	index->nodes.Finalize();
+
+	if (member_way_ids.empty()) {
+		return index;
+	}
+
+	auto handle = fs.OpenFile(file_name, FileFlags::FILE_FLAGS_READ, FileLockType::READ_LOCK);
+	auto file_size = handle->GetFileSize();
+	GlobalState pass(std::move(handle), file_size, 1);
+	for (auto blob = pass.GetNextBlob(context); blob; blob = pass.GetNextBlob(context)) {
+		if (blob->type == FileBlockType::Data) {
+			auto block = DecompressBlob(context, *blob);
+			IndexMemberWays(*block, *index, member_way_ids);
+		}
+	}
+	return index;
+}
+
+// Joins the ways into closed rings of node ids. Returns false if the ways do not form closed rings.
+static bool AssembleRings(const vector<const vector<int64_t> *> &ways, vector<vector<int64_t>> &rings) {
+	vector<bool> used(ways.size(), false);
+	for (idx_t start = 0; start < ways.size(); start++) {
+		if (used[start]) {
+			continue;
+		}
+		used[start] = true;
+		auto ring = *ways[start];
+		if (ring.empty()) {
+			return false;
+		}
+		while (ring.front() != ring.back()) {
+			bool extended = false;
+			for (idx_t i = 0; i < ways.size() && !extended; i++) {
+				auto &way = *ways[i];
+				if (used[i] || way.empty()) {
+					continue;
+				}
+				if (way.front() == ring.back()) {
+					ring.insert(ring.end(), way.begin() + 1, way.end());
+					extended = true;
+				} else if (way.back() == ring.back()) {
+					ring.insert(ring.end(), way.rbegin() + 1, way.rend());
+					extended = true;
+				}
+				used[i] = extended;
+			}
+			if (!extended) {
+				return false;
+			}
+		}
+		if (ring.size() < 4) {
+			return false;
+		}
+		rings.push_back(std::move(ring));
+	}
+	return true;
+}
 
 static unique_ptr<GlobalTableFunctionState> InitGlobal(ClientContext &context, TableFunctionInitInput &input) {
 	auto &bind_data = (BindData &)*input.bind_data;
@@ -252,17 +993,65 @@ static unique_ptr<GlobalTableFunctionState> InitGlobal(ClientContext &context, T
 		throw ParserException("First blob in file is not a header");
 	}
 
+	// The geometries can only be assembled once the locations of all nodes are known
+	bool project_geometry = false;
+	for (auto column_id : input.column_ids) {
+		project_geometry = project_geometry || column_id == OsmColumn::GEOMETRY;
+	}
+	if (bind_data.geometry && project_geometry) {
+		global_state->geometry_index = BuildGeometryIndex(context, file_name);
+	}
+
 	return std::move(global_state);
 }
 
 struct LocalState : LocalTableFunctionState {
+	// The handle the blobs of this thread are read with, the shared handle is only used to read the headers
+	unique_ptr<FileHandle> blob_handle;
 	unique_ptr<FileBlock> block;
 	vector<string> string_table;
 	int32_t granularity;
 	int64_t lat_offset;
 	int64_t lon_offset;
 
-	explicit LocalState(unique_ptr<FileBlock> block) : block(std::move(block)) {
+	// The kinds and tag keys pushed down from the filters of the query
+	const BindData &bind_data;
+	// The ids of each required tag key in the string table of the current block. Writers are not required to
+	// deduplicate the string table, so a key may be stored (and referenced) more than once.
+	vector<vector<uint32_t>> required_key_ids;
+
+	// The position of each column in the output, or DConstants::INVALID_INDEX if it is not projected
+	idx_t column_positions[OsmColumn::COUNT];
+	// The projected columns of the chunk that is being filled, nullptr if the column is not projected.
+	// The fields of the columns that are not projected are skipped instead of decoded.
+	Vector *columns[OsmColumn::COUNT];
+
+	// Used to assemble the geometries, if the geometry column is projected
+	GeometryFactory factory;
+	unique_ptr<NodeLocationStore::Reader> node_reader;
+	OsmGeometryIndex *geometry_index;
+	// The ids in the string table of the current block of the tags that decide the geometry type
+	uint32_t area_key;
+	uint32_t no_value;
+	uint32_t type_key;
+	uint32_t multipolygon_value;
+
+	LocalState(ClientContext &context, unique_ptr<FileBlock> block, const BindData &bind_data,
+	           const vector<column_t> &column_ids, OsmGeometryIndex *geometry_index)
+	    : block(std::move(block)), bind_data(bind_data), factory(BufferAllocator::Get(context)),
+	      geometry_index(geometry_index) {
+		if (geometry_index) {
+			node_reader = make_uniq<NodeLocationStore::Reader>(geometry_index->nodes);
+		}
+		for (idx_t col_idx = 0; col_idx < OsmColumn::COUNT; col_idx++) {
+			column_positions[col_idx] = DConstants::INVALID_INDEX;
+			columns[col_idx] = nullptr;
+		}
+		for (idx_t i = 0; i < column_ids.size(); i++) {
+			if (column_ids[i] < OsmColumn::COUNT) {
+				column_positions[column_ids[i]] = i;
+			}
+		}
 		Reset();
 	}
 
@@ -285,6 +1074,51 @@ struct LocalState : LocalTableFunctionState {
 		}
 
 		state = ParseState::Block;
+
+		area_key = FindString(string_table, "area");
+		no_value = FindString(string_table, "no");
+		type_key = FindString(string_table, "type");
+		multipolygon_value = FindString(string_table, "multipolygon");
+
+		// Resolve the required tag keys once per block. If a key is not in the string table,
+		// no entity in the block can have it, and the whole block is skipped.
+		auto &required_keys = bind_data.required_tag_keys;
+		required_key_ids.assign(required_keys.size(), vector<uint32_t>());
+		for (idx_t string_idx = 0; string_idx < string_table.size(); string_idx++) {
+			for (idx_t key_idx = 0; key_idx < required_keys.size(); key_idx++) {
+				if (string_table[string_idx] == required_keys[key_idx]) {
+					required_key_ids[key_idx].push_back((uint32_t)string_idx);
+				}
+			}
+		}
+		for (auto &key_ids : required_key_ids) {
+			if (key_ids.empty()) {
+				state = ParseState::End;
+				return;
+			}
+		}
+	}
+
+	static bool IsKey(const vector<uint32_t> &key_ids, uint32_t string_id) {
+		return std::find(key_ids.begin(), key_ids.end(), string_id) != key_ids.end();
+	}
+
+	// Whether the tag keys need to be read, either for the tags column or to check the required keys
+	bool ReadTagKeys() const {
+		return columns[OsmColumn::TAGS] || !required_key_ids.empty();
+	}
+
+	bool HasRequiredKeys(const pz::iterator_range<pz::const_varint_iterator<uint32_t>> &key_iter) const {
+		for (auto &key_ids : required_key_ids) {
+			bool found = false;
+			for (auto key = key_iter.begin(); key != key_iter.end() && !found; ++key) {
+				found = IsKey(key_ids, *key);
+			}
+			if (!found) {
+				return false;
+			}
+		}
+		return true;
 	}
 
 	pz::pbf_reader block_reader;
@@ -304,6 +1138,11 @@ struct LocalState : LocalTableFunctionState {
 	// Returns false if there is data left to read but we've reached the capacity
 	// Returns true if block is empty and we are done
 	bool TryRead(DataChunk &output, idx_t &index, idx_t capacity) {
+		for (idx_t col_idx = 0; col_idx < OsmColumn::COUNT; col_idx++) {
+			auto position = column_positions[col_idx];
+			columns[col_idx] = position == DConstants::INVALID_INDEX ? nullptr : &output.data[position];
+		}
+
 		// Main finite state machine
 		while (index < capacity) {
 			switch (state) {
@@ -331,20 +1170,36 @@ struct LocalState : LocalTableFunctionState {
 					switch (group_reader.tag()) {
 					// Nodes
 					case 1: {
-						ScanNode(output, index, capacity);
+						if (bind_data.kinds[0]) {
+							ScanNode(index);
+						} else {
+							group_reader.skip();
+						}
 					} break;
 					// Dense nodes
 					case 2: {
-						PrepareDenseNodes(output, index, capacity);
-						state = ParseState::DenseNodes;
+						if (bind_data.kinds[0]) {
+							PrepareDenseNodes();
+							state = ParseState::DenseNodes;
+						} else {
+							group_reader.skip();
+						}
 					} break;
 					// Way
 					case 3: {
-						ScanWay(output, index, capacity);
+						if (bind_data.kinds[1]) {
+							ScanWay(index);
+						} else {
+							group_reader.skip();
+						}
 					} break;
 					// Relation
 					case 4: {
-						ScanRelation(output, index, capacity);
+						if (bind_data.kinds[2]) {
+							ScanRelation(index);
+						} else {
+							group_reader.skip();
+						}
 					} break;
 					// Changeset
 					case 5: {
@@ -360,7 +1215,7 @@ struct LocalState : LocalTableFunctionState {
 				}
 				break;
 			case ParseState::DenseNodes: {
-				auto done = ScanDenseNodes(output, index, capacity);
+				auto done = ScanDenseNodes(index, capacity);
 				if (done) {
 					state = ParseState::Group;
 				}
@@ -373,74 +1228,292 @@ struct LocalState : LocalTableFunctionState {
 		return false;
 	}
 
-	void ScanNode(DataChunk &output, idx_t &index, idx_t capacity) {
+	void SetNull(idx_t column, idx_t index) {
+		if (columns[column]) {
+			FlatVector::SetNull(*columns[column], index, true);
+		}
+	}
+
+	void WriteKindAndId(idx_t index, uint8_t kind, int64_t id) {
+		if (columns[OsmColumn::KIND]) {
+			FlatVector::GetData<uint8_t>(*columns[OsmColumn::KIND])[index] = kind;
+		}
+		if (columns[OsmColumn::ID]) {
+			FlatVector::GetData<int64_t>(*columns[OsmColumn::ID])[index] = id;
+		}
+	}
+
+	void WriteTags(idx_t index, const pz::iterator_range<pz::const_varint_iterator<uint32_t>> &key_iter,
+	               const pz::iterator_range<pz::const_varint_iterator<uint32_t>> &val_iter) {
+		if (!columns[OsmColumn::TAGS]) {
+			return;
+		}
+		auto &tags = *columns[OsmColumn::TAGS];
+		if (key_iter.empty() || val_iter.empty()) {
+			FlatVector::SetNull(tags, index, true);
+			return;
+		}
+
+		auto tag_count = key_iter.size();
+		auto total_tags = ListVector::GetListSize(tags);
+		ListVector::Reserve(tags, total_tags + tag_count);
+		ListVector::SetListSize(tags, total_tags + tag_count);
+		auto &tag_entry = ListVector::GetData(tags)[index];
+
+		tag_entry.offset = total_tags;
+		tag_entry.length = tag_count;
+
+		auto &key_vector = MapVector::GetKeys(tags);
+		auto &value_vector = MapVector::GetValues(tags);
+
+		auto keys = key_iter.begin();
+		auto vals = val_iter.begin();
+		for (idx_t i = tag_entry.offset; i < tag_entry.offset + tag_count; i++) {
+			FlatVector::GetData<string_t>(key_vector)[i] = StringVector::AddString(key_vector, string_table[*keys++]);
+			FlatVector::GetData<string_t>(value_vector)[i] =
+			    StringVector::AddString(value_vector, string_table[*vals++]);
+		}
+	}
+
+	void WriteRefs(idx_t index, const pz::iterator_range<pz::const_svarint_iterator<int64_t>> &ref_iter) {
+		if (!columns[OsmColumn::REFS]) {
+			return;
+		}
+		auto &refs = *columns[OsmColumn::REFS];
+		if (ref_iter.empty()) {
+			FlatVector::SetNull(refs, index, true);
+			return;
+		}
+
+		auto ref_count = ref_iter.size();
+		auto total_refs = ListVector::GetListSize(refs);
+		ListVector::Reserve(refs, total_refs + ref_count);
+		ListVector::SetListSize(refs, total_refs + ref_count);
+		auto &ref_entry = ListVector::GetData(refs)[index];
+		auto &ref_vector = ListVector::GetEntry(refs);
+		ref_entry.offset = total_refs;
+		ref_entry.length = ref_count;
+
+		auto ref_data = FlatVector::GetData<int64_t>(ref_vector);
+
+		// The refs are delta encoded
+		int64_t last_ref = 0;
+		for (auto ref : ref_iter) {
+			last_ref += ref;
+			ref_data[total_refs++] = last_ref;
+		}
+	}
+
+	void WriteNodeGeometry(idx_t index, int64_t lat_nano, int64_t lon_nano) {
+		if (!columns[OsmColumn::GEOMETRY]) {
+			return;
+		}
+		auto &geometry = *columns[OsmColumn::GEOMETRY];
+		auto point = factory.CreatePoint(lon_nano / OSM_NANODEGREES, lat_nano / OSM_NANODEGREES);
+		FlatVector::GetData<string_t>(geometry)[index] = factory.Serialize(geometry, Geometry(point));
+	}
+
+	// Looks up the locations of the nodes, returns false if any of them is not in the file
+	bool TryResolveNodes(const vector<int64_t> &refs, VertexVector &vertices) {
+		vertices = factory.AllocateVertexVector((uint32_t)refs.size());
+		for (auto ref : refs) {
+			Vertex vertex;
+			if (!node_reader->TryGet(ref, vertex)) {
+				return false;
+			}
+			vertices.Add(vertex);
+		}
+		return true;
+	}
+
+	// Closed ways become polygons unless they are tagged area=no, other ways become linestrings
+	void WriteWayGeometry(idx_t index, const pz::iterator_range<pz::const_varint_iterator<uint32_t>> &key_iter,
+	                      const pz::iterator_range<pz::const_varint_iterator<uint32_t>> &val_iter,
+	                      const pz::iterator_range<pz::const_svarint_iterator<int64_t>> &ref_iter) {
+		if (!columns[OsmColumn::GEOMETRY]) {
+			return;
+		}
+		auto &geometry = *columns[OsmColumn::GEOMETRY];
+
+		// The refs are delta encoded
+		vector<int64_t> refs;
+		int64_t last_ref = 0;
+		for (auto ref : ref_iter) {
+			last_ref += ref;
+			refs.push_back(last_ref);
+		}
+
+		VertexVector vertices(nullptr, 0, 0);
+		if (refs.size() < 2 || !TryResolveNodes(refs, vertices)) {
+			FlatVector::SetNull(geometry, index, true);
+			return;
+		}
+
+		auto is_closed = refs.size() >= 4 && refs.front() == refs.back();
+		if (is_closed && !HasTag(key_iter, val_iter, area_key, no_value)) {
+			auto polygon = factory.CreatePolygon(1);
+			polygon.Ring(0) = vertices;
+			FlatVector::GetData<string_t>(geometry)[index] = factory.Serialize(geometry, Geometry(polygon));
+		} else {
+			LineString linestring(vertices);
+			FlatVector::GetData<string_t>(geometry)[index] = factory.Serialize(geometry, Geometry(linestring));
+		}
+	}
+
+	// Relations tagged type=multipolygon become multipolygons. The member ways are joined into rings by their role,
+	// and each inner ring becomes a hole of the outer ring that contains it.
+	void WriteRelationGeometry(idx_t index, const pz::iterator_range<pz::const_varint_iterator<uint32_t>> &key_iter,
+	                           const pz::iterator_range<pz::const_varint_iterator<uint32_t>> &val_iter,
+	                           const pz::iterator_range<pz::const_varint_iterator<int32_t>> &role_iter,
+	                           const pz::iterator_range<pz::const_svarint_iterator<int64_t>> &ref_iter,
+	                           const pz::iterator_range<pz::const_varint_iterator<int32_t>> &type_iter) {
+		if (!columns[OsmColumn::GEOMETRY]) {
+			return;
+		}
+		auto &geometry = *columns[OsmColumn::GEOMETRY];
+		if (!HasTag(key_iter, val_iter, type_key, multipolygon_value)) {
+			FlatVector::SetNull(geometry, index, true);
+			return;
+		}
+
+		vector<const vector<int64_t> *> outer_ways;
+		vector<const vector<int64_t> *> inner_ways;
+		int64_t ref = 0;
+		auto roles = role_iter.begin();
+		auto types = type_iter.begin();
+		for (auto refs = ref_iter.begin(); refs != ref_iter.end() && roles != role_iter.end() && types != type_iter.end();
+		     ++refs, ++roles, ++types) {
+			ref += *refs;
+			if (*types != 1) {
+				continue;
+			}
+			auto way = geometry_index->member_ways.find(ref);
+			if (way == geometry_index->member_ways.end()) {
+				// The relation is incomplete
+				FlatVector::SetNull(geometry, index, true);
+				return;
+			}
+			// Members without a role are treated as outer ways
+			if (string_table[*roles] == "inner") {
+				inner_ways.push_back(&way->second);
+			} else {
+				outer_ways.push_back(&way->second);
+			}
+		}
+
+		vector<vector<int64_t>> outer_rings;
+		vector<vector<int64_t>> inner_rings;
+		if (!AssembleRings(outer_ways, outer_rings) || !AssembleRings(inner_ways, inner_rings) ||
+		    outer_rings.empty()) {
+			FlatVector::SetNull(geometry, index, true);
+			return;
+		}
+
+		vector<VertexVector> outers;
+		vector<vector<VertexVector>> holes(outer_rings.size());
+		for (auto &ring : outer_rings) {
+			VertexVector vertices(nullptr, 0, 0);
+			if (!TryResolveNodes(ring, vertices)) {
+				FlatVector::SetNull(geometry, index, true);
+				return;
+			}
+			outers.push_back(vertices);
+		}
+		for (auto &ring : inner_rings) {
+			VertexVector vertices(nullptr, 0, 0);
+			if (!TryResolveNodes(ring, vertices)) {
+				FlatVector::SetNull(geometry, index, true);
+				return;
+			}
+			// Inner rings that are not inside any outer ring are dropped
+			for (idx_t i = 0; i < outers.size(); i++) {
+				if (outers[i].ContainsVertex(vertices.Get(0)) != Contains::OUTSIDE) {
+					holes[i].push_back(vertices);
+					break;
+				}
+			}
+		}
+
+		auto multipolygon = factory.CreateMultiPolygon((uint32_t)outers.size());
+		for (idx_t i = 0; i < outers.size(); i++) {
+			auto polygon = factory.CreatePolygon((uint32_t)(1 + holes[i].size()));
+			polygon.Ring(0) = outers[i];
+			for (idx_t j = 0; j < holes[i].size(); j++) {
+				polygon.Ring(1 + j) = holes[i][j];
+			}
+			multipolygon[i] = polygon;
+		}
+		FlatVector::GetData<string_t>(geometry)[index] = factory.Serialize(geometry, Geometry(multipolygon));
+	}
+
+	void ScanNode(idx_t &index) {
 
 		auto node = group_reader.get_message();
 
 		pz::iterator_range<pz::const_varint_iterator<uint32_t>> key_iter;
 		pz::iterator_range<pz::const_varint_iterator<uint32_t>> val_iter;
+		int64_t lat = 0;
+		int64_t lon = 0;
 
 		while (node.next()) {
 			switch (node.tag()) {
 			case 1: { // ID
-				auto id = node.get_int64();
-				FlatVector::GetData<uint8_t>(output.data[0])[index] = 0;
-				FlatVector::GetData<int64_t>(output.data[1])[index] = id;
+				WriteKindAndId(index, 0, node.get_int64());
 			} break;
 			case 2: { // Tag Keys
-				key_iter = node.get_packed_uint32();
+				if (ReadTagKeys()) {
+					key_iter = node.get_packed_uint32();
+				} else {
+					node.skip();
+				}
 			} break;
 			case 3: { // Tag Vals
-				val_iter = node.get_packed_uint32();
+				if (columns[OsmColumn::TAGS]) {
+					val_iter = node.get_packed_uint32();
+				} else {
+					node.skip();
+				}
 			} break;
 			case 8: { // Lat
-				auto lat = node.get_sint64();
-				FlatVector::GetData<double>(output.data[4])[index] = 0.000000001 * (lat_offset + (granularity * lat));
+				if (columns[OsmColumn::LAT] || columns[OsmColumn::GEOMETRY]) {
+					lat = lat_offset + (granularity * node.get_sint64());
+					if (columns[OsmColumn::LAT]) {
+						FlatVector::GetData<double>(*columns[OsmColumn::LAT])[index] = 0.000000001 * lat;
+					}
+				} else {
+					node.skip();
+				}
 			} break;
 			case 9: { // Lon
-				auto lon = node.get_sint64();
-				FlatVector::GetData<double>(output.data[5])[index] = 0.000000001 * (lon_offset + (granularity * lon));
+				if (columns[OsmColumn::LON] || columns[OsmColumn::GEOMETRY]) {
+					lon = lon_offset + (granularity * node.get_sint64());
+					if (columns[OsmColumn::LON]) {
+						FlatVector::GetData<double>(*columns[OsmColumn::LON])[index] = 0.000000001 * lon;
+					}
+				} else {
+					node.skip();
+				}
 			} break;
 			default:
 				node.skip();
 			}
 		}
 
-		// Read tags
-		if (!key_iter.empty() && !val_iter.empty()) {
-			auto tag_count = key_iter.size();
-			auto total_tags = ListVector::GetListSize(output.data[2]);
-			ListVector::Reserve(output.data[2], total_tags + tag_count);
-			ListVector::SetListSize(output.data[2], total_tags + tag_count);
-			auto &tag_entry = ListVector::GetData(output.data[2])[index];
-
-			tag_entry.offset = total_tags;
-			tag_entry.length = tag_count;
-
-			auto &key_vector = MapVector::GetKeys(output.data[2]);
-			auto &value_vector = MapVector::GetValues(output.data[2]);
-
-			auto keys = key_iter.begin();
-			auto vals = val_iter.begin();
-			for (idx_t i = tag_entry.offset; i < tag_entry.offset + tag_count; i++) {
-				FlatVector::GetData<string_t>(key_vector)[i] =
-				    StringVector::AddString(key_vector, string_table[*keys++]);
-				FlatVector::GetData<string_t>(value_vector)[i] =
-				    StringVector::AddString(value_vector, string_table[*vals++]);
-			}
-		} else {
-			FlatVector::SetNull(output.data[2], index, true);
+		if (!HasRequiredKeys(key_iter)) {
+			return;
 		}
+		WriteTags(index, key_iter, val_iter);
+		WriteNodeGeometry(index, lat, lon);
 
 		// Node has no refs, ref_roles or ref_types
-		FlatVector::SetNull(output.data[3], index, true);
-		FlatVector::SetNull(output.data[6], index, true);
-		FlatVector::SetNull(output.data[7], index, true);
+		SetNull(OsmColumn::REFS, index);
+		SetNull(OsmColumn::REF_ROLES, index);
+		SetNull(OsmColumn::REF_TYPES, index);
 
 		index++;
 	}
 
-	void PrepareDenseNodes(DataChunk &output, idx_t &index, idx_t capacity) {
+	void PrepareDenseNodes() {
 		dense_node_index = 0;
 		dense_node_ids.clear();
 		dense_node_tags.clear();
@@ -453,6 +1526,7 @@ struct LocalState : LocalTableFunctionState {
 		while (dense_nodes.next()) {
 			switch (dense_nodes.tag()) {
 			case 1: { // ID
+				// The ids are always read, as they determine the number of nodes
 				auto ids = dense_nodes.get_packed_sint64();
 				int64_t last_id = 0;
 				for (auto id : ids) {
@@ -461,6 +1535,10 @@ struct LocalState : LocalTableFunctionState {
 				}
 			} break;
 			case 8: { // Lats
+				if (!columns[OsmColumn::LAT] && !columns[OsmColumn::GEOMETRY]) {
+					dense_nodes.skip();
+					break;
+				}
 				auto lats = dense_nodes.get_packed_sint64();
 				int64_t last_lat = 0;
 				for (auto lat : lats) {
@@ -469,6 +1547,10 @@ struct LocalState : LocalTableFunctionState {
 				}
 			} break;
 			case 9: { // Lons
+				if (!columns[OsmColumn::LON] && !columns[OsmColumn::GEOMETRY]) {
+					dense_nodes.skip();
+					break;
+				}
 				auto lons = dense_nodes.get_packed_sint64();
 				int64_t last_lon = 0;
 				for (auto lon : lons) {
@@ -477,6 +1559,10 @@ struct LocalState : LocalTableFunctionState {
 				}
 			} break;
 			case 10: { // Tags
+				if (!ReadTagKeys()) {
+					dense_nodes.skip();
+					break;
+				}
 				auto tags = dense_nodes.get_packed_uint32();
 				idx_t entry_offset = 0;
 				for (auto tag : tags) {
@@ -495,7 +1581,7 @@ struct LocalState : LocalTableFunctionState {
 		}
 	}
 
-	void ScanWay(DataChunk &output, idx_t &index, idx_t capacity) {
+	void ScanWay(idx_t &index) {
 		auto way = group_reader.get_message();
 
 		pz::iterator_range<pz::const_varint_iterator<uint32_t>> key_iter;
@@ -505,77 +1591,51 @@ struct LocalState : LocalTableFunctionState {
 		while (way.next()) {
 			switch (way.tag()) {
 			case 1: { // ID
-				auto id = way.get_int64();
-				FlatVector::GetData<uint8_t>(output.data[0])[index] = 1;
-				FlatVector::GetData<int64_t>(output.data[1])[index] = id;
-				FlatVector::SetNull(output.data[4], index, true);
-				FlatVector::SetNull(output.data[5], index, true);
-				FlatVector::SetNull(output.data[6], index, true);
-				FlatVector::SetNull(output.data[7], index, true);
+				WriteKindAndId(index, 1, way.get_int64());
 			} break;
 			case 2: { // Tag Keys
-				key_iter = way.get_packed_uint32();
+				if (ReadTagKeys() || columns[OsmColumn::GEOMETRY]) {
+					key_iter = way.get_packed_uint32();
+				} else {
+					way.skip();
+				}
 			} break;
 			case 3: { // Tag Vals
-				val_iter = way.get_packed_uint32();
+				if (columns[OsmColumn::TAGS] || columns[OsmColumn::GEOMETRY]) {
+					val_iter = way.get_packed_uint32();
+				} else {
+					way.skip();
+				}
 			} break;
 			case 8: { // Refs
-				ref_iter = way.get_packed_sint64();
+				if (columns[OsmColumn::REFS] || columns[OsmColumn::GEOMETRY]) {
+					ref_iter = way.get_packed_sint64();
+				} else {
+					way.skip();
+				}
 			} break;
 			default:
 				way.skip();
 			}
 		}
-		if (!key_iter.empty() && !val_iter.empty()) {
-			auto tag_count = key_iter.size();
-			auto total_tags = ListVector::GetListSize(output.data[2]);
-			ListVector::Reserve(output.data[2], total_tags + tag_count);
-			ListVector::SetListSize(output.data[2], total_tags + tag_count);
-			auto &tag_entry = ListVector::GetData(output.data[2])[index];
 
-			tag_entry.offset = total_tags;
-			tag_entry.length = tag_count;
-
-			auto &key_vector = MapVector::GetKeys(output.data[2]);
-			auto &value_vector = MapVector::GetValues(output.data[2]);
-
-			auto keys = key_iter.begin();
-			auto vals = val_iter.begin();
-			for (idx_t i = tag_entry.offset; i < tag_entry.offset + tag_count; i++) {
-				FlatVector::GetData<string_t>(key_vector)[i] =
-				    StringVector::AddString(key_vector, string_table[*keys++]);
-				FlatVector::GetData<string_t>(value_vector)[i] =
-				    StringVector::AddString(value_vector, string_table[*vals++]);
-			}
-		} else {
-			FlatVector::SetNull(output.data[2], index, true);
+		if (!HasRequiredKeys(key_iter)) {
+			return;
 		}
+		WriteTags(index, key_iter, val_iter);
+		WriteRefs(index, ref_iter);
+		WriteWayGeometry(index, key_iter, val_iter, ref_iter);
 
-		if (!ref_iter.empty()) {
-			auto ref_count = ref_iter.size();
-			auto total_refs = ListVector::GetListSize(output.data[3]);
-			ListVector::Reserve(output.data[3], total_refs + ref_count);
-			ListVector::SetListSize(output.data[3], total_refs + ref_count);
-			auto &ref_entry = ListVector::GetData(output.data[3])[index];
-			auto &ref_vector = ListVector::GetEntry(output.data[3]);
-			ref_entry.offset = total_refs;
-			ref_entry.length = ref_count;
-
-			auto ref_data = FlatVector::GetData<int64_t>(ref_vector);
-
-			int64_t last_ref = 0;
-			for (auto ref : ref_iter) {
-				last_ref += ref;
-				ref_data[total_refs++] = last_ref;
-			}
-		} else {
-			FlatVector::SetNull(output.data[3], index, true);
-		}
+		// Way has no lat, lon, ref_roles or ref_types
+		SetNull(OsmColumn::LAT, index);
+		SetNull(OsmColumn::LON, index);
+		SetNull(OsmColumn::REF_ROLES, index);
+		SetNull(OsmColumn::REF_TYPES, index);
 
 		index++;
 	}
 
-	void ScanRelation(DataChunk &output, idx_t &index, idx_t capacity) {
+	void ScanRelation(idx_t &index) {
 		auto relation = group_reader.get_message();
 
 		pz::iterator_range<pz::const_varint_iterator<uint32_t>> key_iter;
@@ -587,68 +1647,63 @@ struct LocalState : LocalTableFunctionState {
 		while (relation.next()) {
 			switch (relation.tag()) {
 			case 1: { // ID
-				auto id = relation.get_int64();
-				FlatVector::GetData<uint8_t>(output.data[0])[index] = 2;
-				FlatVector::GetData<int64_t>(output.data[1])[index] = id;
-				FlatVector::SetNull(output.data[4], index, true);
-				FlatVector::SetNull(output.data[5], index, true);
+				WriteKindAndId(index, 2, relation.get_int64());
 			} break;
 			case 2: { // Tag Keys
-				key_iter = relation.get_packed_uint32();
+				if (ReadTagKeys() || columns[OsmColumn::GEOMETRY]) {
+					key_iter = relation.get_packed_uint32();
+				} else {
+					relation.skip();
+				}
 			} break;
 			case 3: { // Tag Vals
-				val_iter = relation.get_packed_uint32();
+				if (columns[OsmColumn::TAGS] || columns[OsmColumn::GEOMETRY]) {
+					val_iter = relation.get_packed_uint32();
+				} else {
+					relation.skip();
+				}
 			} break;
 			case 8: { // Roles
-				role_iter = relation.get_packed_int32();
+				if (columns[OsmColumn::REF_ROLES] || columns[OsmColumn::GEOMETRY]) {
+					role_iter = relation.get_packed_int32();
+				} else {
+					relation.skip();
+				}
 			} break;
 			case 9: { // Refs
-				ref_iter = relation.get_packed_sint64();
+				if (columns[OsmColumn::REFS] || columns[OsmColumn::GEOMETRY]) {
+					ref_iter = relation.get_packed_sint64();
+				} else {
+					relation.skip();
+				}
 			} break;
 			case 10: { // Types
-				type_iter = relation.get_packed_int32();
+				if (columns[OsmColumn::REF_TYPES] || columns[OsmColumn::GEOMETRY]) {
+					type_iter = relation.get_packed_int32();
+				} else {
+					relation.skip();
+				}
 			} break;
 			default:
 				relation.skip();
 			}
 		}
 
-		// Read tags
-		if (!key_iter.empty() && !val_iter.empty()) {
-			auto tag_count = key_iter.size();
-
-			auto total_tags = ListVector::GetListSize(output.data[2]);
-			ListVector::Reserve(output.data[2], total_tags + tag_count);
-			ListVector::SetListSize(output.data[2], total_tags + tag_count);
-			auto &tag_entry = ListVector::GetData(output.data[2])[index];
-
-			tag_entry.offset = total_tags;
-			tag_entry.length = tag_count;
-
-			auto &key_vector = MapVector::GetKeys(output.data[2]);
-			auto &value_vector = MapVector::GetValues(output.data[2]);
-
-			auto keys = key_iter.begin();
-			auto vals = val_iter.begin();
-			for (idx_t i = tag_entry.offset; i < tag_entry.offset + tag_count; i++) {
-				FlatVector::GetData<string_t>(key_vector)[i] =
-				    StringVector::AddString(key_vector, string_table[*keys++]);
-				FlatVector::GetData<string_t>(value_vector)[i] =
-				    StringVector::AddString(value_vector, string_table[*vals++]);
-			}
-		} else {
-			FlatVector::SetNull(output.data[2], index, true);
+		if (!HasRequiredKeys(key_iter)) {
+			return;
 		}
+		WriteTags(index, key_iter, val_iter);
 
 		// Roles
-		if (!role_iter.empty()) {
+		if (columns[OsmColumn::REF_ROLES] && !role_iter.empty()) {
+			auto &roles_list = *columns[OsmColumn::REF_ROLES];
 			auto role_count = role_iter.size();
 
-			auto total_roles = ListVector::GetListSize(output.data[6]);
-			ListVector::Reserve(output.data[6], total_roles + role_count);
-			ListVector::SetListSize(output.data[6], total_roles + role_count);
-			auto &role_entry = ListVector::GetData(output.data[6])[index];
-			auto &role_vector = ListVector::GetEntry(output.data[6]);
+			auto total_roles = ListVector::GetListSize(roles_list);
+			ListVector::Reserve(roles_list, total_roles + role_count);
+			ListVector::SetListSize(roles_list, total_roles + role_count);
+			auto &role_entry = ListVector::GetData(roles_list)[index];
+			auto &role_vector = ListVector::GetEntry(roles_list);
 			role_entry.offset = total_roles;
 			role_entry.length = role_count;
 
@@ -662,41 +1717,22 @@ struct LocalState : LocalTableFunctionState {
 				}
 			}
 		} else {
-			FlatVector::SetNull(output.data[6], index, true);
+			SetNull(OsmColumn::REF_ROLES, index);
 		}
 
 		// Refs
-		if (!ref_iter.empty()) {
-			auto ref_count = ref_iter.size();
-
-			auto total_refs = ListVector::GetListSize(output.data[3]);
-			ListVector::Reserve(output.data[3], total_refs + ref_count);
-			ListVector::SetListSize(output.data[3], total_refs + ref_count);
-			auto &ref_entry = ListVector::GetData(output.data[3])[index];
-			auto &ref_vector = ListVector::GetEntry(output.data[3]);
-			ref_entry.offset = total_refs;
-			ref_entry.length = ref_count;
-
-			auto ref_data = FlatVector::GetData<int64_t>(ref_vector);
-
-			int64_t last_ref = 0;
-			for (auto ref : ref_iter) {
-				last_ref += ref;
-				ref_data[total_refs++] = last_ref;
-			}
-		} else {
-			FlatVector::SetNull(output.data[3], index, true);
-		}
+		WriteRefs(index, ref_iter);
 
 		// Types
-		if (!type_iter.empty()) {
+		if (columns[OsmColumn::REF_TYPES] && !type_iter.empty()) {
+			auto &types_list = *columns[OsmColumn::REF_TYPES];
 			auto type_count = type_iter.size();
 
-			auto total_types = ListVector::GetListSize(output.data[7]);
-			ListVector::Reserve(output.data[7], total_types + type_count);
-			ListVector::SetListSize(output.data[7], total_types + type_count);
-			auto &type_entry = ListVector::GetData(output.data[7])[index];
-			auto &type_vector = ListVector::GetEntry(output.data[7]);
+			auto total_types = ListVector::GetListSize(types_list);
+			ListVector::Reserve(types_list, total_types + type_count);
+			ListVector::SetListSize(types_list, total_types + type_count);
+			auto &type_entry = ListVector::GetData(types_list)[index];
+			auto &type_vector = ListVector::GetEntry(types_list);
 			type_entry.offset = total_types;
 			type_entry.length = type_count;
 
@@ -705,49 +1741,81 @@ struct LocalState : LocalTableFunctionState {
 				type_data[total_types++] = (uint8_t)type;
 			}
 		} else {
-			FlatVector::SetNull(output.data[7], index, true);
+			SetNull(OsmColumn::REF_TYPES, index);
 		}
 
+		WriteRelationGeometry(index, key_iter, val_iter, role_iter, ref_iter, type_iter);
+
+		// Relation has no lat or lon
+		SetNull(OsmColumn::LAT, index);
+		SetNull(OsmColumn::LON, index);
+
 		index++;
 	}
 
+	bool DenseNodeHasRequiredKeys() const {
+		if (required_key_ids.empty()) {
+			return true;
+		}
+		if (dense_node_index >= dense_node_tag_entries.size()) {
+			return false;
+		}
+		// The tags are stored as key/value pairs, so the keys are at the even offsets
+		auto entry = dense_node_tag_entries[dense_node_index];
+		for (auto &key_ids : required_key_ids) {
+			bool found = false;
+			for (idx_t t = entry.offset; t < entry.offset + entry.length && !found; t += 2) {
+				found = IsKey(key_ids, dense_node_tags[t]);
+			}
+			if (!found) {
+				return false;
+			}
+		}
+		return true;
+	}
+
 	// Returns true if done (all dense nodes have been read)
-	bool ScanDenseNodes(DataChunk &output, idx_t &index, idx_t capacity) {
+	bool ScanDenseNodes(idx_t &index, idx_t capacity) {
 		// Write multiple nodes at once as long as we have capacity
-		auto nodes_to_write = capacity - index;
-		auto nodes_to_read = std::min(nodes_to_write, dense_node_ids.size() - dense_node_index);
-
-		auto kind_data = FlatVector::GetData<uint8_t>(output.data[0]);
-		auto id_data = FlatVector::GetData<int64_t>(output.data[1]);
-		auto lat_data = FlatVector::GetData<double>(output.data[4]);
-		auto lon_data = FlatVector::GetData<double>(output.data[5]);
+		auto tags = columns[OsmColumn::TAGS];
 
-		for (idx_t i = 0; i < nodes_to_read; i++) {
-			auto id = dense_node_ids[dense_node_index];
+		for (; index < capacity && dense_node_index < dense_node_ids.size(); dense_node_index++) {
+			if (!DenseNodeHasRequiredKeys()) {
+				continue;
+			}
 
-			id_data[index] = id;
-			kind_data[index] = 0;
-			lat_data[index] = 0.000000001 * (lat_offset + (granularity * dense_node_lats[dense_node_index]));
-			lon_data[index] = 0.000000001 * (lon_offset + (granularity * dense_node_lons[dense_node_index]));
+			WriteKindAndId(index, 0, dense_node_ids[dense_node_index]);
+			if (columns[OsmColumn::LAT]) {
+				FlatVector::GetData<double>(*columns[OsmColumn::LAT])[index] =
+				    0.000000001 * (lat_offset + (granularity * dense_node_lats[dense_node_index]));
+			}
+			if (columns[OsmColumn::LON]) {
+				FlatVector::GetData<double>(*columns[OsmColumn::LON])[index] =
+				    0.000000001 * (lon_offset + (granularity * dense_node_lons[dense_node_index]));
+			}
+			if (columns[OsmColumn::GEOMETRY]) {
+				WriteNodeGeometry(index, lat_offset + (granularity * dense_node_lats[dense_node_index]),
+				                  lon_offset + (granularity * dense_node_lons[dense_node_index]));
+			}
 
 			// Do we have tags in this block?
-			if (!dense_node_tags.empty()) {
+			if (tags && !dense_node_tags.empty()) {
 				auto entry = dense_node_tag_entries[dense_node_index];
 				if (entry.length != 0) {
 					// Dense nodes tags are stored as a list of key/value pairs,
 					// therefore we need to divide the length by 2 to get the number of tags
 					auto tag_count = entry.length / 2;
 
-					auto total_tags = ListVector::GetListSize(output.data[2]);
-					ListVector::Reserve(output.data[2], total_tags + tag_count);
-					ListVector::SetListSize(output.data[2], total_tags + tag_count);
-					auto &tag_entry = ListVector::GetData(output.data[2])[index];
+					auto total_tags = ListVector::GetListSize(*tags);
+					ListVector::Reserve(*tags, total_tags + tag_count);
+					ListVector::SetListSize(*tags, total_tags + tag_count);
+					auto &tag_entry = ListVector::GetData(*tags)[index];
 
 					tag_entry.offset = total_tags;
 					tag_entry.length = tag_count;
 
-					auto &key_vector = MapVector::GetKeys(output.data[2]);
-					auto &value_vector = MapVector::GetValues(output.data[2]);
+					auto &key_vector = MapVector::GetKeys(*tags);
+					auto &value_vector = MapVector::GetValues(*tags);
 
 					idx_t t = entry.offset;
 					idx_t r = tag_entry.offset;
@@ -765,18 +1833,17 @@ struct LocalState : LocalTableFunctionState {
 						r += 1;
 					}
 				} else {
-					FlatVector::SetNull(output.data[2], index, true);
+					FlatVector::SetNull(*tags, index, true);
 				}
 			} else {
-				FlatVector::SetNull(output.data[2], index, true);
+				SetNull(OsmColumn::TAGS, index);
 			}
-			FlatVector::SetNull(output.data[3], index, true);
+			SetNull(OsmColumn::REFS, index);
 
 			// No ref types or roles for dense nodes
-			FlatVector::SetNull(output.data[6], index, true);
-			FlatVector::SetNull(output.data[7], index, true);
+			SetNull(OsmColumn::REF_ROLES, index);
+			SetNull(OsmColumn::REF_TYPES, index);
 
-			dense_node_index++;
 			index++;
 		}
 		if (dense_node_index >= dense_node_ids.size()) {
@@ -788,16 +1855,25 @@ struct LocalState : LocalTableFunctionState {
 
 static unique_ptr<LocalTableFunctionState> InitLocal(ExecutionContext &context, TableFunctionInitInput &input,
                                                      GlobalTableFunctionState *global_state) {
-	// auto &bind_data = (BindData &)*input.bind_data;
+	auto &bind_data = (BindData &)*input.bind_data;
 	auto &global = (GlobalState &)*global_state;
 
-	auto blob = global.GetNextBlob(context.client);
+	// The filters of the query pass none of the kinds of entities
+	if (!bind_data.kinds[0] && !bind_data.kinds[1] && !bind_data.kinds[2]) {
+		return nullptr;
+	}
+
+	auto &fs = FileSystem::GetFileSystem(context.client);
+	auto blob_handle = fs.OpenFile(bind_data.file_name, FileFlags::FILE_FLAGS_READ, FileLockType::READ_LOCK);
+	auto blob = global.GetNextBlob(context.client, *blob_handle);
 	if (blob == nullptr) {
 		return nullptr;
 	}
 	auto block = DecompressBlob(context.client, *blob);
 
-	auto result = make_uniq<LocalState>(std::move(block));
+	auto result = make_uniq<LocalState>(context.client, std::move(block), bind_data, input.column_ids,
+	                                    global.geometry_index.get());
+	result->blob_handle = std::move(blob_handle);
 	return std::move(result);
 }
 
@@ -809,6 +1885,7 @@ static void Execute(ClientContext &context, TableFunctionInput &input, DataChunk
 	// auto &bind_data = (BindData &)*input.bind_data;
 	auto &global_state = (GlobalState &)*input.global_state;
 	auto &local_state = (LocalState &)*input.local_state;
+	local_state.factory.allocator.Reset();
 
 	idx_t row_id = 0;
 	idx_t capacity = STANDARD_VECTOR_SIZE;
@@ -816,7 +1893,7 @@ static void Execute(ClientContext &context, TableFunctionInput &input, DataChunk
 	while (row_id < capacity) {
 		bool done = local_state.TryRead(output, row_id, capacity);
 		if (done) {
-			auto next = global_state.GetNextBlob(context);
+			auto next = global_state.GetNextBlob(context, *local_state.blob_handle);
 			if (next.get() == nullptr) {
 				break;
 			}
@@ -861,6 +1938,9 @@ void CoreTableFunctions::RegisterOsmTableFunction(DatabaseInstance &db) {
 
 	read.get_batch_index = GetBatchIndex;
 	read.table_scan_progress = Progress;
+	read.projection_pushdown = true;
+	read.pushdown_complex_filter = PushdownComplexFilter;
+	read.named_parameters["geometry"] = LogicalType::BOOLEAN;
 
 	ExtensionUtil::RegisterFunction(db, read);
 
@@ -511,6 +511,75 @@ bool GeometryFactory::TryGetSerializedBoundingBox(const string_t &data, Bounding
 	return false;
 }
 
+bool GeometryFactory::TryGetSerializedRectangle(const string_t &data, BoundingBox &bbox) {
+	Cursor cursor(data);
+
+	auto header = cursor.Read<GeometryHeader>();
+	if (header.type != GeometryType::POLYGON || !header.properties.HasBBox()) {
+		return false;
+	}
+	cursor.Skip(4);  // skip padding
+	cursor.Skip(16); // skip the (float) bounding box, we need the exact extent
+
+	auto type = cursor.Read<SerializedGeometryType>();
+	D_ASSERT(type == SerializedGeometryType::POLYGON);
+	(void)type;
+
+	// A single ring, which is closed and has exactly 4 distinct corners
+	auto num_rings = cursor.Read<uint32_t>();
+	if (num_rings != 1) {
+		return false;
+	}
+	auto num_vertices = cursor.Read<uint32_t>();
+	if (num_vertices != 5) {
+		return false;
+	}
+	cursor.Skip(4); // skip padding
+
+	double x[5];
+	double y[5];
+	for (idx_t i = 0; i < 5; i++) {
+		x[i] = cursor.Read<double>();
+		y[i] = cursor.Read<double>();
+	}
+	if (x[0] != x[4] || y[0] != y[4]) {
+		return false;
+	}
+
+	auto minx = std::min(std::min(x[0], x[1]), std::min(x[2], x[3]));
+	auto maxx = std::max(std::max(x[0], x[1]), std::max(x[2], x[3]));
+	auto miny = std::min(std::min(y[0], y[1]), std::min(y[2], y[3]));
+	auto maxy = std::max(std::max(y[0], y[1]), std::max(y[2], y[3]));
+	if (!(minx < maxx) || !(miny < maxy)) {
+		return false;
+	}
+
+	bool moves_x[4];
+	for (idx_t i = 0; i < 4; i++) {
+		// Every vertex has to be a corner of the extent...
+		if ((x[i] != minx && x[i] != maxx) || (y[i] != miny && y[i] != maxy)) {
+			return false;
+		}
+		// ...and every edge has to move along exactly one axis
+		moves_x[i] = x[i] != x[i + 1];
+		if (moves_x[i] == (y[i] != y[i + 1])) {
+			return false;
+		}
+	}
+	// Consecutive edges have to be perpendicular, otherwise the ring folds back onto itself
+	for (idx_t i = 0; i < 4; i++) {
+		if (moves_x[i] == moves_x[(i + 1) % 4]) {
+			return false;
+		}
+	}
+
+	bbox.minx = minx;
+	bbox.miny = miny;
+	bbox.maxx = maxx;
+	bbox.maxy = maxy;
+	return true;
+}
+
 //----------------------------------------------------------------------
 // Serialized Size
 //----------------------------------------------------------------------
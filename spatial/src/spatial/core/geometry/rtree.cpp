@@ -0,0 +1,102 @@
+#include "spatial/common.hpp"
+#include "spatial/core/geometry/rtree.hpp"
+
+namespace spatial {
+
+namespace core {
+
+static double CenterX(const BoundingBox &box) {
+	return box.minx + (box.maxx - box.minx) / 2;
+}
+
+static double CenterY(const BoundingBox &box) {
+	return box.miny + (box.maxy - box.miny) / 2;
+}
+
+static void ExpandBox(BoundingBox &target, const BoundingBox &box) {
+	target.minx = MinValue(target.minx, box.minx);
+	target.miny = MinValue(target.miny, box.miny);
+	target.maxx = MaxValue(target.maxx, box.maxx);
+	target.maxy = MaxValue(target.maxy, box.maxy);
+}
+
+FlatRTree::FlatRTree(vector<BoundingBox> boxes) {
+	auto count = boxes.size();
+	if (count == 0) {
+		return;
+	}
+
+	// Sort-Tile-Recursive: sort all items by x, cut them into vertical slices of
+	// roughly sqrt(leaf_count) leaves each, and then sort each slice by y.
+	item_ids.resize(count);
+	for (idx_t i = 0; i < count; i++) {
+		item_ids[i] = i;
+	}
+
+	auto leaf_count = (count + NODE_CAPACITY - 1) / NODE_CAPACITY;
+	auto slice_count = static_cast<idx_t>(std::ceil(std::sqrt(static_cast<double>(leaf_count))));
+	auto slice_size = slice_count * NODE_CAPACITY;
+
+	std::sort(item_ids.begin(), item_ids.end(),
+	          [&](idx_t a, idx_t b) { return CenterX(boxes[a]) < CenterX(boxes[b]); });
+
+	for (idx_t slice_start = 0; slice_start < count; slice_start += slice_size) {
+		auto slice_end = MinValue(slice_start + slice_size, count);
+		std::sort(item_ids.begin() + slice_start, item_ids.begin() + slice_end,
+		          [&](idx_t a, idx_t b) { return CenterY(boxes[a]) < CenterY(boxes[b]); });
+	}
+
+	// Level 0: the items in packed order
+	vector<BoundingBox> items;
+	items.reserve(count);
+	for (auto &id : item_ids) {
+		items.push_back(boxes[id]);
+	}
+	levels.push_back(std::move(items));
+
+	// Pack the upper levels until we reach the root
+	while (levels.back().size() > 1) {
+		auto &children = levels.back();
+		vector<BoundingBox> parents;
+		parents.reserve((children.size() + NODE_CAPACITY - 1) / NODE_CAPACITY);
+		for (idx_t i = 0; i < children.size(); i += NODE_CAPACITY) {
+			BoundingBox node;
+			auto end = MinValue(i + NODE_CAPACITY, static_cast<idx_t>(children.size()));
+			for (idx_t j = i; j < end; j++) {
+				ExpandBox(node, children[j]);
+			}
+			parents.push_back(node);
+		}
+		levels.push_back(std::move(parents));
+	}
+
+	bounds = levels.back()[0];
+}
+
+void FlatRTree::SearchNode(const BoundingBox &query, idx_t level, idx_t node_idx, vector<idx_t> &result) const {
+	auto &boxes = levels[level];
+	if (!boxes[node_idx].Intersects(query)) {
+		return;
+	}
+	if (level == 0) {
+		result.push_back(item_ids[node_idx]);
+		return;
+	}
+	auto &children = levels[level - 1];
+	auto begin = node_idx * NODE_CAPACITY;
+	auto end = MinValue(begin + NODE_CAPACITY, static_cast<idx_t>(children.size()));
+	for (idx_t child_idx = begin; child_idx < end; child_idx++) {
+		SearchNode(query, level - 1, child_idx, result);
+	}
+}
+
+void FlatRTree::Search(const BoundingBox &query, vector<idx_t> &result) const {
+	if (levels.empty()) {
+		return;
+	}
+	SearchNode(query, levels.size() - 1, 0, result);
+}
+
+} // namespace core
+
+} // namespace spatial
@@ -0,0 +1,380 @@
+#include "spatial/common.hpp"
+#include "spatial/core/geometry/geometry.hpp"
+#include "spatial/core/geometry/wkb_reader.hpp"
+#include "spatial/core/geometry/wkb_transcoder.hpp"
+
+namespace spatial {
+
+namespace core {
+
+//------------------------------------------------------------------------------
+// Reading
+//------------------------------------------------------------------------------
+template <>
+uint32_t WKBTranscoder::ReadInt<WKBByteOrder::NDR>() {
+	if (cursor + sizeof(uint32_t) > length) {
+		throw SerializationException("WKBReader: ReadInt: not enough data");
+	}
+	auto result = Load<uint32_t>((const_data_ptr_t)data + cursor);
+	cursor += sizeof(uint32_t);
+	return result;
+}
+
+template <>
+double WKBTranscoder::ReadDouble<WKBByteOrder::NDR>() {
+	if (cursor + sizeof(double) > length) {
+		throw SerializationException("WKBReader: ReadDouble: not enough data");
+	}
+	auto result = Load<double>((const_data_ptr_t)data + cursor);
+	cursor += sizeof(double);
+	return result;
+}
+
+template <>
+uint32_t WKBTranscoder::ReadInt<WKBByteOrder::XDR>() {
+	if (cursor + sizeof(uint32_t) > length) {
+		throw SerializationException("WKBReader: ReadInt: not enough data");
+	}
+	uint32_t result = 0;
+	result |= (uint32_t)data[cursor + 0] << 24 & 0xFF000000;
+	result |= (uint32_t)data[cursor + 1] << 16 & 0x00FF0000;
+	result |= (uint32_t)data[cursor + 2] << 8 & 0x0000FF00;
+	result |= (uint32_t)data[cursor + 3] << 0 & 0x000000FF;
+	cursor += sizeof(uint32_t);
+	return result;
+}
+
+template <>
+double WKBTranscoder::ReadDouble<WKBByteOrder::XDR>() {
+	if (cursor + sizeof(double) > length) {
+		throw SerializationException("WKBReader: ReadDouble: not enough data");
+	}
+	uint64_t bits = 0;
+	bits |= (uint64_t)data[cursor + 0] << 56 & 0xFF00000000000000;
+	bits |= (uint64_t)data[cursor + 1] << 48 & 0x00FF000000000000;
+	bits |= (uint64_t)data[cursor + 2] << 40 & 0x0000FF0000000000;
+	bits |= (uint64_t)data[cursor + 3] << 32 & 0x000000FF00000000;
+	bits |= (uint64_t)data[cursor + 4] << 24 & 0x00000000FF000000;
+	bits |= (uint64_t)data[cursor + 5] << 16 & 0x0000000000FF0000;
+	bits |= (uint64_t)data[cursor + 6] << 8 & 0x000000000000FF00;
+	bits |= (uint64_t)data[cursor + 7] << 0 & 0x00000000000000FF;
+	cursor += sizeof(double);
+	double result;
+	memcpy(&result, &bits, sizeof(double));
+	return result;
+}
+
+WKBByteOrder WKBTranscoder::ReadByteOrder() {
+	if (cursor + sizeof(uint8_t) > length) {
+		throw SerializationException("WKBReader: ReadByteOrder: not enough data");
+	}
+	return static_cast<WKBByteOrder>(data[cursor++]);
+}
+
+template <WKBByteOrder ORDER>
+WKBGeometryType WKBTranscoder::ReadType() {
+	auto type = ReadInt<ORDER>();
+	if ((type & 0x80000000) == 0x80000000) {
+		throw NotImplementedException(
+		    "Z value present in WKB, DuckDB spatial does not support geometries with Z coordinates yet");
+	}
+	if ((type & 0x40000000) == 0x40000000) {
+		throw NotImplementedException(
+		    "M value present in WKB, DuckDB spatial does not support geometries with M coordinates yet");
+	}
+	if ((type & 0x20000000) == 0x20000000) {
+		// Skip and ignore the srid for now
+		ReadInt<ORDER>();
+		type &= ~0x20000000;
+	}
+	if (type < static_cast<uint32_t>(WKBGeometryType::POINT) ||
+	    type > static_cast<uint32_t>(WKBGeometryType::GEOMETRYCOLLECTION)) {
+		throw NotImplementedException("Geometry type '%u' not supported", type);
+	}
+	return static_cast<WKBGeometryType>(type);
+}
+
+void WKBTranscoder::SkipVertices(uint32_t count) {
+	auto bytes = static_cast<uint64_t>(count) * sizeof(double) * 2;
+	if (cursor + bytes > length) {
+		throw SerializationException("WKBReader: ReadDouble: not enough data");
+	}
+	cursor += static_cast<uint32_t>(bytes);
+}
+
+static GeometryType ToGeometryType(WKBGeometryType type) {
+	// The WKB type codes are offset by one from the internal (and serialized) geometry types
+	return static_cast<GeometryType>(static_cast<uint32_t>(type) - 1);
+}
+
+static const char *WKBTypeName(WKBGeometryType type) {
+	switch (type) {
+	case WKBGeometryType::POINT:
+		return "POINT";
+	case WKBGeometryType::LINESTRING:
+		return "LINESTRING";
+	case WKBGeometryType::POLYGON:
+		return "POLYGON";
+	case WKBGeometryType::MULTIPOINT:
+		return "MULTIPOINT";
+	case WKBGeometryType::MULTILINESTRING:
+		return "MULTILINESTRING";
+	case WKBGeometryType::MULTIPOLYGON:
+		return "MULTIPOLYGON";
+	default:
+		return "GEOMETRYCOLLECTION";
+	}
+}
+
+//------------------------------------------------------------------------------
+// Measure
+//------------------------------------------------------------------------------
+uint32_t WKBTranscoder::MeasureGeometry(bool is_root, bool has_expected_type, WKBGeometryType expected_type) {
+	auto order = ReadByteOrder();
+	if (order == WKBByteOrder::XDR) {
+		auto type = ReadType<WKBByteOrder::XDR>();
+		if (has_expected_type && type != expected_type) {
+			throw InvalidInputException("Expected %s, got %u", WKBTypeName(expected_type), type);
+		}
+		return MeasureGeometryBody<WKBByteOrder::XDR>(is_root, type);
+	} else {
+		auto type = ReadType<WKBByteOrder::NDR>();
+		if (has_expected_type && type != expected_type) {
+			throw InvalidInputException("Expected %s, got %u", WKBTypeName(expected_type), type);
+		}
+		return MeasureGeometryBody<WKBByteOrder::NDR>(is_root, type);
+	}
+}
+
+template <WKBByteOrder ORDER>
+uint32_t WKBTranscoder::MeasureGeometryBody(bool is_root, WKBGeometryType wkb_type) {
+	// 4 bytes for the type, 4 bytes for the count
+	uint32_t size = 4 + 4;
+	uint32_t count = 0;
+
+	switch (wkb_type) {
+	case WKBGeometryType::POINT: {
+		auto x = ReadDouble<ORDER>();
+		auto y = ReadDouble<ORDER>();
+		// WKB has no empty points, a point with NaN coordinates is used instead
+		count = (std::isnan(x) && std::isnan(y)) ? 0 : 1;
+		size += count * sizeof(Vertex);
+		break;
+	}
+	case WKBGeometryType::LINESTRING: {
+		count = ReadInt<ORDER>();
+		SkipVertices(count);
+		size += count * sizeof(Vertex);
+		break;
+	}
+	case WKBGeometryType::POLYGON: {
+		count = ReadInt<ORDER>();
+		for (uint32_t i = 0; i < count; i++) {
+			auto ring_count = ReadInt<ORDER>();
+			SkipVertices(ring_count);
+			size += 4 + ring_count * sizeof(Vertex);
+		}
+		if (count % 2 == 1) {
+			// Padding
+			size += 4;
+		}
+		break;
+	}
+	case WKBGeometryType::MULTIPOINT: {
+		count = ReadInt<ORDER>();
+		for (uint32_t i = 0; i < count; i++) {
+			size += MeasureGeometry(false, true, WKBGeometryType::POINT);
+		}
+		break;
+	}
+	case WKBGeometryType::MULTILINESTRING: {
+		count = ReadInt<ORDER>();
+		for (uint32_t i = 0; i < count; i++) {
+			size += MeasureGeometry(false, true, WKBGeometryType::LINESTRING);
+		}
+		break;
+	}
+	case WKBGeometryType::MULTIPOLYGON: {
+		count = ReadInt<ORDER>();
+		for (uint32_t i = 0; i < count; i++) {
+			size += MeasureGeometry(false, true, WKBGeometryType::POLYGON);
+		}
+		break;
+	}
+	case WKBGeometryType::GEOMETRYCOLLECTION: {
+		count = ReadInt<ORDER>();
+		for (uint32_t i = 0; i < count; i++) {
+			size += MeasureGeometry(false, false, WKBGeometryType::GEOMETRYCOLLECTION);
+		}
+		break;
+	}
+	default:
+		throw NotImplementedException("Geometry type '%u' not supported", wkb_type);
+	}
+
+	if (is_root) {
+		type = ToGeometryType(wkb_type);
+		is_empty = count == 0;
+	}
+	return size;
+}
+
+uint32_t WKBTranscoder::Measure() {
+	cursor = 0;
+	geom_size = MeasureGeometry(true, false, WKBGeometryType::GEOMETRYCOLLECTION);
+
+	// Must match the layout written by GeometryFactory::Serialize
+	bool has_bbox = type != GeometryType::POINT && !is_empty;
+	return sizeof(GeometryHeader) + 4 + (has_bbox ? 16 : 0) + geom_size;
+}
+
+//------------------------------------------------------------------------------
+// Write
+//------------------------------------------------------------------------------
+template <WKBByteOrder ORDER>
+void WKBTranscoder::WriteVertices(Cursor &out, BoundingBox &bbox, uint32_t count, bool update_bounds) {
+	for (uint32_t i = 0; i < count; i++) {
+		auto x = ReadDouble<ORDER>();
+		auto y = ReadDouble<ORDER>();
+		if (update_bounds) {
+			bbox.minx = std::min(bbox.minx, x);
+			bbox.miny = std::min(bbox.miny, y);
+			bbox.maxx = std::max(bbox.maxx, x);
+			bbox.maxy = std::max(bbox.maxy, y);
+		}
+		out.Write<double>(x);
+		out.Write<double>(y);
+	}
+}
+
+void WKBTranscoder::WriteGeometry(Cursor &out, BoundingBox &bbox) {
+	// The input has already been validated by Measure()
+	auto order = ReadByteOrder();
+	if (order == WKBByteOrder::XDR) {
+		auto type = ReadType<WKBByteOrder::XDR>();
+		WriteGeometryBody<WKBByteOrder::XDR>(out, bbox, type);
+	} else {
+		auto type = ReadType<WKBByteOrder::NDR>();
+		WriteGeometryBody<WKBByteOrder::NDR>(out, bbox, type);
+	}
+}
+
+template <WKBByteOrder ORDER>
+void WKBTranscoder::WriteGeometryBody(Cursor &out, BoundingBox &bbox, WKBGeometryType wkb_type) {
+	out.Write<uint32_t>(static_cast<uint32_t>(ToGeometryType(wkb_type)));
+
+	switch (wkb_type) {
+	case WKBGeometryType::POINT: {
+		auto x = ReadDouble<ORDER>();
+		auto y = ReadDouble<ORDER>();
+		if (std::isnan(x) && std::isnan(y)) {
+			out.Write<uint32_t>(0);
+			break;
+		}
+		out.Write<uint32_t>(1);
+		bbox.minx = std::min(bbox.minx, x);
+		bbox.miny = std::min(bbox.miny, y);
+		bbox.maxx = std::max(bbox.maxx, x);
+		bbox.maxy = std::max(bbox.maxy, y);
+		out.Write<double>(x);
+		out.Write<double>(y);
+		break;
+	}
+	case WKBGeometryType::LINESTRING: {
+		auto count = ReadInt<ORDER>();
+		out.Write<uint32_t>(count);
+		WriteVertices<ORDER>(out, bbox, count, true);
+		break;
+	}
+	case WKBGeometryType::POLYGON: {
+		auto num_rings = ReadInt<ORDER>();
+		out.Write<uint32_t>(num_rings);
+
+		// The ring counts are stored up front in the serialized format, while WKB interleaves them with the
+		// ring data, so write the ring data first and come back for the counts.
+		auto counts_ptr = out.GetPtr();
+		out.Skip(num_rings * 4);
+		if (num_rings % 2 == 1) {
+			out.Write<uint32_t>(0);
+		}
+		for (uint32_t i = 0; i < num_rings; i++) {
+			auto ring_count = ReadInt<ORDER>();
+			Store<uint32_t>(ring_count, counts_ptr + i * 4);
+			// Only the shell contributes to the bounding box
+			WriteVertices<ORDER>(out, bbox, ring_count, i == 0);
+		}
+		break;
+	}
+	case WKBGeometryType::MULTIPOINT:
+	case WKBGeometryType::MULTILINESTRING:
+	case WKBGeometryType::MULTIPOLYGON:
+	case WKBGeometryType::GEOMETRYCOLLECTION: {
+		auto count = ReadInt<ORDER>();
+		out.Write<uint32_t>(count);
+		for (uint32_t i = 0; i < count; i++) {
+			WriteGeometry(out, bbox);
+		}
+		break;
+	}
+	default:
+		throw NotImplementedException("Geometry type '%u' not supported", wkb_type);
+	}
+}
+
+void WKBTranscoder::Write(string_t &blob) {
+	cursor = 0;
+	bool has_bbox = type != GeometryType::POINT && !is_empty;
+
+	GeometryProperties properties;
+	properties.SetBBox(has_bbox);
+	uint16_t hash = 0;
+	for (uint32_t i = 0; i < sizeof(uint32_t); i++) {
+		hash ^= (geom_size >> (i * 8)) & 0xFF;
+	}
+	GeometryHeader header(type, properties, hash);
+
+	Cursor out(blob);
+	out.Write(header);
+	// Padding
+	out.Write<uint32_t>(0);
+
+	BoundingBox bbox;
+	auto bbox_ptr = out.GetPtr();
+	if (has_bbox) {
+		out.Skip(16);
+	}
+
+	WriteGeometry(out, bbox);
+
+	if (has_bbox) {
+		out.SetPtr(bbox_ptr);
+		out.Write<float>(Utils::DoubleToFloatDown(bbox.minx));
+		out.Write<float>(Utils::DoubleToFloatDown(bbox.miny));
+		out.Write<float>(Utils::DoubleToFloatUp(bbox.maxx));
+		out.Write<float>(Utils::DoubleToFloatUp(bbox.maxy));
+	}
+	blob.Finalize();
+}
+
+//------------------------------------------------------------------------------
+// Transcode
+//------------------------------------------------------------------------------
+string_t WKBTranscoder::Transcode(Vector &result, const char *data, uint32_t length) {
+	WKBTranscoder transcoder(data, length);
+	auto size = transcoder.Measure();
+	auto blob = StringVector::EmptyString(result, size);
+	transcoder.Write(blob);
+	return blob;
+}
+
+string_t WKBTranscoder::Transcode(VectorStringBuffer &buffer, const char *data, uint32_t length) {
+	WKBTranscoder transcoder(data, length);
+	auto size = transcoder.Measure();
+	auto blob = buffer.EmptyString(size);
+	transcoder.Write(blob);
+	return blob;
+}
+
+} // namespace core
+
+} // namespace spatial
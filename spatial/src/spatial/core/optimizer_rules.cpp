@@ -12,6 +12,8 @@
 #include "duckdb/planner/operator/logical_join.hpp"
 #include "spatial/common.hpp"
 #include "spatial/core/optimizer_rules.hpp"
+#include "spatial/core/spatial_join.hpp"
+#include "spatial/core/types.hpp"
 
 namespace spatial {
 
@@ -29,6 +31,10 @@ namespace core {
 //	All spatial predicates (except st_disjoint) imply an intersection of the
 //  bounding boxes of the two geometries.
 //
+//  If both sides of the predicate are GEOMETRY we instead emit a dedicated
+//  spatial join, which builds an R-tree over the bounding boxes of the smaller
+//  side and probes it with the other.
+//
 class RangeJoinSpatialPredicateRewriter : public OptimizerExtension {
 public:
 	RangeJoinSpatialPredicateRewriter() {
@@ -142,6 +148,19 @@ public:
 						std::swap(left_pred_expr, right_pred_expr);
 					}
 
+					if (left_pred_expr->return_type == GeoTypes::GEOMETRY() &&
+					    right_pred_expr->return_type == GeoTypes::GEOMETRY()) {
+						auto spatial_join = make_uniq<LogicalSpatialJoin>(
+						    std::move(any_join.condition), std::move(left_pred_expr), std::move(right_pred_expr));
+						spatial_join->children = std::move(any_join.children);
+						if (any_join.has_estimated_cardinality) {
+							spatial_join->estimated_cardinality = any_join.estimated_cardinality;
+							spatial_join->has_estimated_cardinality = true;
+						}
+						plan = std::move(spatial_join);
+						return;
+					}
+
 					// Lookup the st_xmin, st_xmax, st_ymin, st_ymax functions in the catalog
 					auto &catalog = Catalog::GetSystemCatalog(context);
 					auto &xmin_func_set =
@@ -251,6 +270,96 @@ public:
 	}
 };
 
+//------------------------------------------------------------------------------
+// Spatial Filter Extent Rewriter
+//------------------------------------------------------------------------------
+//
+//  Adds a st_intersects_extent filter in front of spatial predicates that
+//  compare a geometry to a constant, e.g.
+//
+//		WHERE st_intersects(geom, <constant>)
+//	=>	WHERE st_intersects_extent(geom, <constant>) AND st_intersects(geom, <constant>)
+//
+//  The extent check only reads the bounding box from the serialized geometry
+//  header, so most rows outside the query window are discarded without ever
+//  deserializing them. All spatial predicates (except st_disjoint) imply an
+//  intersection of the bounding boxes of the two geometries. st_equals is
+//  left out, as two empty geometries (without a bounding box) are equal.
+//
+class SpatialFilterExtentRewriter : public OptimizerExtension {
+public:
+	SpatialFilterExtentRewriter() {
+		optimize_function = SpatialFilterExtentRewriter::Optimize;
+	}
+
+	static void TryOptimize(ClientContext &context, OptimizerExtensionInfo *info, unique_ptr<LogicalOperator> &plan) {
+		if (plan->type != LogicalOperatorType::LOGICAL_FILTER) {
+			return;
+		}
+		auto &filter = plan->Cast<LogicalFilter>();
+
+		case_insensitive_set_t predicates = {"st_intersects", "st_touches", "st_crosses",   "st_within",
+		                                     "st_contains",   "st_overlaps", "st_covers",   "st_coveredby",
+		                                     "st_containsproperly"};
+
+		vector<unique_ptr<Expression>> extent_filters;
+		for (auto &expr : filter.expressions) {
+			if (expr->type != ExpressionType::BOUND_FUNCTION) {
+				continue;
+			}
+			auto &bound_function = expr->Cast<BoundFunctionExpression>();
+			if (predicates.find(bound_function.function.name) == predicates.end() ||
+			    bound_function.children.size() != 2) {
+				continue;
+			}
+
+			auto &left = bound_function.children[0];
+			auto &right = bound_function.children[1];
+			if (left->return_type != GeoTypes::GEOMETRY() || right->return_type != GeoTypes::GEOMETRY()) {
+				continue;
+			}
+			// Only rewrite if exactly one side is constant, otherwise the predicate is cheap enough
+			// (both constant) or better handled by a join
+			if (left->IsFoldable() == right->IsFoldable()) {
+				continue;
+			}
+
+			auto &catalog = Catalog::GetSystemCatalog(context);
+			auto &extent_func_set =
+			    catalog.GetEntry(context, CatalogType::SCALAR_FUNCTION_ENTRY, DEFAULT_SCHEMA, "st_intersects_extent")
+			        .Cast<ScalarFunctionCatalogEntry>();
+			auto extent_func = extent_func_set.functions.GetFunctionByArguments(
+			    context, {GeoTypes::GEOMETRY(), GeoTypes::GEOMETRY()});
+
+			vector<unique_ptr<Expression>> extent_args;
+			extent_args.push_back(left->Copy());
+			extent_args.push_back(right->Copy());
+			extent_filters.push_back(make_uniq<BoundFunctionExpression>(LogicalType::BOOLEAN, std::move(extent_func),
+			                                                            std::move(extent_args), nullptr));
+		}
+
+		if (extent_filters.empty()) {
+			return;
+		}
+
+		// Evaluate the cheap extent checks first
+		for (auto &expr : filter.expressions) {
+			extent_filters.push_back(std::move(expr));
+		}
+		filter.expressions = std::move(extent_filters);
+	}
+
+	static void Optimize(ClientContext &context, OptimizerExtensionInfo *info, unique_ptr<LogicalOperator> &plan) {
+
+		TryOptimize(context, info, plan);
+
+		// Recursively optimize the children
+		for (auto &child : plan->children) {
+			Optimize(context, info, child);
+		}
+	}
+};
+
 //------------------------------------------------------------------------------
 // Register optimizers
 //------------------------------------------------------------------------------
@@ -263,6 +372,7 @@ void CoreOptimizerRules::Register(DatabaseInstance &db) {
 
 	// Register the optimizer rules
 	config.optimizer_extensions.push_back(RangeJoinSpatialPredicateRewriter());
+	config.optimizer_extensions.push_back(SpatialFilterExtentRewriter());
 
 	con.Commit();
 }
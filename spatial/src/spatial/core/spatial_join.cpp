@@ -0,0 +1,359 @@
+#include "spatial/common.hpp"
+#include "spatial/core/spatial_join.hpp"
+#include "spatial/core/geometry/geometry_factory.hpp"
+#include "spatial/core/geometry/rtree.hpp"
+
+#include "duckdb/common/types/column/column_data_collection.hpp"
+#include "duckdb/execution/expression_executor.hpp"
+#include "duckdb/execution/physical_plan_generator.hpp"
+#include "duckdb/planner/expression/bound_columnref_expression.hpp"
+#include "duckdb/planner/expression/bound_reference_expression.hpp"
+#include "duckdb/planner/expression_iterator.hpp"
+
+namespace spatial {
+
+namespace core {
+
+//------------------------------------------------------------------------------
+// Logical Spatial Join
+//------------------------------------------------------------------------------
+LogicalSpatialJoin::LogicalSpatialJoin(unique_ptr<Expression> condition_p, unique_ptr<Expression> left_key_p,
+                                       unique_ptr<Expression> right_key_p)
+    : condition(std::move(condition_p)), left_key(std::move(left_key_p)), right_key(std::move(right_key_p)) {
+}
+
+vector<ColumnBinding> LogicalSpatialJoin::GetColumnBindings() {
+	auto bindings = children[0]->GetColumnBindings();
+	auto right_bindings = children[1]->GetColumnBindings();
+	bindings.insert(bindings.end(), right_bindings.begin(), right_bindings.end());
+	return bindings;
+}
+
+void LogicalSpatialJoin::ResolveTypes() {
+	types = children[0]->types;
+	types.insert(types.end(), children[1]->types.begin(), children[1]->types.end());
+}
+
+string LogicalSpatialJoin::GetName() const {
+	return "SPATIAL_JOIN";
+}
+
+string LogicalSpatialJoin::ParamsToString() const {
+	return condition->GetName();
+}
+
+// The column binding resolver does not know how to resolve the expressions of an
+// extension operator that reference both of its children, so we do it ourselves.
+static void ResolveColumnReferences(unique_ptr<Expression> &expr, const vector<ColumnBinding> &bindings) {
+	if (expr->type == ExpressionType::BOUND_COLUMN_REF) {
+		auto &colref = expr->Cast<BoundColumnRefExpression>();
+		for (idx_t i = 0; i < bindings.size(); i++) {
+			if (colref.binding == bindings[i]) {
+				expr = make_uniq<BoundReferenceExpression>(colref.alias, colref.return_type, i);
+				return;
+			}
+		}
+		throw InternalException("Failed to resolve column reference in spatial join condition");
+	}
+	ExpressionIterator::EnumerateChildren(
+	    *expr, [&](unique_ptr<Expression> &child) { ResolveColumnReferences(child, bindings); });
+}
+
+unique_ptr<PhysicalOperator> LogicalSpatialJoin::CreatePlan(ClientContext &context, PhysicalPlanGenerator &generator) {
+	auto left_bindings = children[0]->GetColumnBindings();
+	auto right_bindings = children[1]->GetColumnBindings();
+	auto all_bindings = GetColumnBindings();
+
+	ResolveColumnReferences(condition, all_bindings);
+	ResolveColumnReferences(left_key, left_bindings);
+	ResolveColumnReferences(right_key, right_bindings);
+
+	auto left = generator.CreatePlan(std::move(children[0]));
+	auto right = generator.CreatePlan(std::move(children[1]));
+
+	// Build the R-tree over the smaller side
+	if (left->estimated_cardinality < right->estimated_cardinality) {
+		return make_uniq<PhysicalSpatialJoin>(*this, std::move(right), std::move(left), std::move(condition),
+		                                      std::move(right_key), std::move(left_key), true, estimated_cardinality);
+	}
+	return make_uniq<PhysicalSpatialJoin>(*this, std::move(left), std::move(right), std::move(condition),
+	                                      std::move(left_key), std::move(right_key), false, estimated_cardinality);
+}
+
+//------------------------------------------------------------------------------
+// Physical Spatial Join
+//------------------------------------------------------------------------------
+PhysicalSpatialJoin::PhysicalSpatialJoin(LogicalOperator &op, unique_ptr<PhysicalOperator> probe,
+                                         unique_ptr<PhysicalOperator> build, unique_ptr<Expression> condition_p,
+                                         unique_ptr<Expression> probe_key_p, unique_ptr<Expression> build_key_p,
+                                         bool build_is_left_p, idx_t estimated_cardinality)
+    : PhysicalJoin(op, PhysicalOperatorType::EXTENSION, JoinType::INNER, estimated_cardinality),
+      condition(std::move(condition_p)), probe_key(std::move(probe_key_p)), build_key(std::move(build_key_p)),
+      build_is_left(build_is_left_p) {
+	children.push_back(std::move(probe));
+	children.push_back(std::move(build));
+}
+
+string PhysicalSpatialJoin::GetName() const {
+	return "SPATIAL_JOIN";
+}
+
+string PhysicalSpatialJoin::ParamsToString() const {
+	return condition->GetName();
+}
+
+//------------------------------------------------------------------------------
+// Sink
+//------------------------------------------------------------------------------
+class SpatialJoinGlobalState : public GlobalSinkState {
+public:
+	SpatialJoinGlobalState(ClientContext &context, const vector<LogicalType> &types) : collection(context, types) {
+	}
+
+	mutex lock;
+	// The build side rows. They are kept in the (buffer managed) collection, so that they can be spilled to disk.
+	ColumnDataCollection collection;
+	// The bounding box of each build side row
+	vector<BoundingBox> boxes;
+
+	// The index of the first row of each chunk of the collection, used to find the rows of the ids in the R-tree
+	vector<idx_t> chunk_offsets;
+	unique_ptr<FlatRTree> tree;
+};
+
+class SpatialJoinLocalState : public LocalSinkState {
+public:
+	SpatialJoinLocalState(ClientContext &context, const PhysicalSpatialJoin &op)
+	    : collection(context, op.children[1]->types), executor(context, *op.build_key) {
+		keys.Initialize(Allocator::Get(context), {op.build_key->return_type});
+		payload.InitializeEmpty(op.children[1]->types);
+	}
+
+	ColumnDataCollection collection;
+	vector<BoundingBox> boxes;
+
+	ExpressionExecutor executor;
+	DataChunk keys;
+	DataChunk payload;
+};
+
+unique_ptr<GlobalSinkState> PhysicalSpatialJoin::GetGlobalSinkState(ClientContext &context) const {
+	return make_uniq<SpatialJoinGlobalState>(context, children[1]->types);
+}
+
+unique_ptr<LocalSinkState> PhysicalSpatialJoin::GetLocalSinkState(ExecutionContext &context) const {
+	return make_uniq<SpatialJoinLocalState>(context.client, *this);
+}
+
+SinkResultType PhysicalSpatialJoin::Sink(ExecutionContext &context, DataChunk &chunk, OperatorSinkInput &input) const {
+	auto &lstate = input.local_state.Cast<SpatialJoinLocalState>();
+	auto count = chunk.size();
+
+	lstate.keys.Reset();
+	lstate.executor.Execute(chunk, lstate.keys);
+
+	UnifiedVectorFormat format;
+	lstate.keys.data[0].ToUnifiedFormat(count, format);
+	auto geometries = UnifiedVectorFormat::GetData<string_t>(format);
+
+	// Only keep the rows that can possibly match, i.e. non-null, non-empty geometries
+	SelectionVector sel(STANDARD_VECTOR_SIZE);
+	idx_t result_count = 0;
+	for (idx_t i = 0; i < count; i++) {
+		auto idx = format.sel->get_index(i);
+		if (!format.validity.RowIsValid(idx)) {
+			continue;
+		}
+		BoundingBox bbox;
+		if (!GeometryFactory::TryGetSerializedBoundingBox(geometries[idx], bbox)) {
+			continue;
+		}
+		lstate.boxes.push_back(bbox);
+		sel.set_index(result_count++, i);
+	}
+
+	if (result_count == count) {
+		lstate.collection.Append(chunk);
+	} else if (result_count > 0) {
+		lstate.payload.Slice(chunk, sel, result_count);
+		lstate.collection.Append(lstate.payload);
+	}
+
+	return SinkResultType::NEED_MORE_INPUT;
+}
+
+SinkCombineResultType PhysicalSpatialJoin::Combine(ExecutionContext &context, OperatorSinkCombineInput &input) const {
+	auto &gstate = input.global_state.Cast<SpatialJoinGlobalState>();
+	auto &lstate = input.local_state.Cast<SpatialJoinLocalState>();
+
+	lock_guard<mutex> guard(gstate.lock);
+	gstate.collection.Combine(lstate.collection);
+	gstate.boxes.insert(gstate.boxes.end(), lstate.boxes.begin(), lstate.boxes.end());
+
+	return SinkCombineResultType::FINISHED;
+}
+
+SinkFinalizeType PhysicalSpatialJoin::Finalize(Pipeline &pipeline, Event &event, ClientContext &context,
+                                               OperatorSinkFinalizeInput &input) const {
+	auto &gstate = input.global_state.Cast<SpatialJoinGlobalState>();
+	auto count = gstate.collection.Count();
+	if (count == 0) {
+		return SinkFinalizeType::NO_OUTPUT_POSSIBLE;
+	}
+
+	// The ids in the R-tree are the indexes of the rows in the collection, record where each chunk starts so that
+	// the rows can be fetched chunk by chunk. Only the first column is scanned to count the rows.
+	gstate.chunk_offsets.reserve(gstate.collection.ChunkCount());
+	idx_t offset = 0;
+	for (auto &chunk : gstate.collection.Chunks({0})) {
+		gstate.chunk_offsets.push_back(offset);
+		offset += chunk.size();
+	}
+
+	gstate.tree = make_uniq<FlatRTree>(std::move(gstate.boxes));
+	return SinkFinalizeType::READY;
+}
+
+//------------------------------------------------------------------------------
+// Operator
+//------------------------------------------------------------------------------
+class SpatialJoinOperatorState : public CachingOperatorState {
+public:
+	SpatialJoinOperatorState(ClientContext &context, const PhysicalSpatialJoin &op)
+	    : key_executor(context, *op.probe_key), condition_executor(context, *op.condition),
+	      match_sel(STANDARD_VECTOR_SIZE) {
+		keys.Initialize(Allocator::Get(context), {op.probe_key->return_type});
+		joined.InitializeEmpty(op.types);
+		build_chunk.Initialize(Allocator::Get(context), op.children[1]->types);
+	}
+
+	struct CandidatePair {
+		idx_t build_idx;
+		sel_t probe_row;
+	};
+
+	ExpressionExecutor key_executor;
+	DataChunk keys;
+
+	ExpressionExecutor condition_executor;
+	DataChunk joined;
+	SelectionVector match_sel;
+
+	// The candidate pairs of the current input chunk, ordered by the build side row
+	bool probing = false;
+	idx_t pair_offset = 0;
+	vector<CandidatePair> pairs;
+	vector<idx_t> search_result;
+
+	// The build side chunk the current pairs are joined with
+	DataChunk build_chunk;
+	idx_t build_chunk_idx = DConstants::INVALID_INDEX;
+};
+
+unique_ptr<OperatorState> PhysicalSpatialJoin::GetOperatorState(ExecutionContext &context) const {
+	return make_uniq<SpatialJoinOperatorState>(context.client, *this);
+}
+
+OperatorResultType PhysicalSpatialJoin::ExecuteInternal(ExecutionContext &context, DataChunk &input, DataChunk &chunk,
+                                                        GlobalOperatorState &gstate_p, OperatorState &state_p) const {
+	auto &gstate = sink_state->Cast<SpatialJoinGlobalState>();
+	auto &state = state_p.Cast<SpatialJoinOperatorState>();
+
+	if (!gstate.tree) {
+		return OperatorResultType::NEED_MORE_INPUT;
+	}
+
+	if (!state.probing) {
+		// New input chunk: collect all candidate pairs whose bounding boxes intersect
+		state.probing = true;
+		state.pair_offset = 0;
+		state.pairs.clear();
+
+		state.keys.Reset();
+		state.key_executor.Execute(input, state.keys);
+
+		UnifiedVectorFormat format;
+		state.keys.data[0].ToUnifiedFormat(input.size(), format);
+		auto geometries = UnifiedVectorFormat::GetData<string_t>(format);
+
+		for (idx_t i = 0; i < input.size(); i++) {
+			auto idx = format.sel->get_index(i);
+			if (!format.validity.RowIsValid(idx)) {
+				continue;
+			}
+			BoundingBox bbox;
+			if (!GeometryFactory::TryGetSerializedBoundingBox(geometries[idx], bbox)) {
+				continue;
+			}
+			state.search_result.clear();
+			gstate.tree->Search(bbox, state.search_result);
+			for (auto &build_idx : state.search_result) {
+				state.pairs.push_back({build_idx, static_cast<sel_t>(i)});
+			}
+		}
+		// Group the pairs by build side chunk, so that each chunk is fetched once per input chunk
+		std::sort(state.pairs.begin(), state.pairs.end(),
+		          [](const SpatialJoinOperatorState::CandidatePair &a,
+		             const SpatialJoinOperatorState::CandidatePair &b) { return a.build_idx < b.build_idx; });
+	}
+
+	// The probe and build columns are laid out in the order of the logical join
+	auto build_col_count = gstate.collection.ColumnCount();
+	auto probe_col_offset = build_is_left ? build_col_count : 0;
+	auto build_col_offset = build_is_left ? 0 : input.ColumnCount();
+	auto &chunk_offsets = gstate.chunk_offsets;
+
+	auto pair_count = state.pairs.size();
+	while (state.pair_offset < pair_count) {
+		// Each batch joins with the rows of a single build side chunk
+		auto first_build_idx = state.pairs[state.pair_offset].build_idx;
+		auto next_chunk = std::upper_bound(chunk_offsets.begin(), chunk_offsets.end(), first_build_idx);
+		auto chunk_idx = idx_t(next_chunk - chunk_offsets.begin()) - 1;
+		auto chunk_start = chunk_offsets[chunk_idx];
+		auto chunk_end = next_chunk == chunk_offsets.end() ? gstate.collection.Count() : *next_chunk;
+		if (chunk_idx != state.build_chunk_idx) {
+			state.build_chunk.Reset();
+			gstate.collection.FetchChunk(chunk_idx, state.build_chunk);
+			state.build_chunk_idx = chunk_idx;
+		}
+
+		SelectionVector probe_sel(STANDARD_VECTOR_SIZE);
+		SelectionVector build_sel(STANDARD_VECTOR_SIZE);
+		idx_t batch_size = 0;
+		while (batch_size < STANDARD_VECTOR_SIZE && state.pair_offset < pair_count &&
+		       state.pairs[state.pair_offset].build_idx < chunk_end) {
+			auto &pair = state.pairs[state.pair_offset++];
+			probe_sel.set_index(batch_size, pair.probe_row);
+			build_sel.set_index(batch_size, pair.build_idx - chunk_start);
+			batch_size++;
+		}
+
+		for (idx_t col_idx = 0; col_idx < input.ColumnCount(); col_idx++) {
+			state.joined.data[probe_col_offset + col_idx].Slice(input.data[col_idx], probe_sel, batch_size);
+		}
+		for (idx_t col_idx = 0; col_idx < build_col_count; col_idx++) {
+			state.joined.data[build_col_offset + col_idx].Slice(state.build_chunk.data[col_idx], build_sel,
+			                                                     batch_size);
+		}
+		state.joined.SetCardinality(batch_size);
+
+		// Evaluate the exact predicate on the candidates
+		auto match_count = state.condition_executor.SelectExpression(state.joined, state.match_sel);
+		if (match_count == 0) {
+			continue;
+		}
+		chunk.Slice(state.joined, state.match_sel, match_count);
+
+		if (state.pair_offset < pair_count) {
+			return OperatorResultType::HAVE_MORE_OUTPUT;
+		}
+		break;
+	}
+
+	state.probing = false;
+	return OperatorResultType::NEED_MORE_INPUT;
+}
+
+} // namespace core
+
+} // namespace spatial
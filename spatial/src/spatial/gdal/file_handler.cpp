@@ -1,8 +1,14 @@
 #include "spatial/gdal/file_handler.hpp"
 
+#include "duckdb/common/unordered_map.hpp"
+#include "duckdb/main/config.hpp"
+
 #include "cpl_vsi.h"
 #include "cpl_string.h"
 
+#include <deque>
+#include <list>
+
 namespace spatial {
 
 namespace gdal {
@@ -24,6 +30,221 @@ ClientContext &GdalFileHandler::GetLocalClientContext() {
 	return *local_context;
 }
 
+//--------------------------------------------------------------------------
+// Statistics
+//--------------------------------------------------------------------------
+
+static atomic<idx_t> bytes_requested {0};
+static atomic<idx_t> bytes_read {0};
+static atomic<idx_t> read_count {0};
+static atomic<idx_t> seek_count {0};
+static atomic<idx_t> cache_hits {0};
+static atomic<idx_t> cache_misses {0};
+
+GdalFileHandlerStats GdalFileHandler::GetStats() {
+	GdalFileHandlerStats stats;
+	stats.bytes_requested = bytes_requested;
+	stats.bytes_read = bytes_read;
+	stats.reads = read_count;
+	stats.seeks = seek_count;
+	stats.cache_hits = cache_hits;
+	stats.cache_misses = cache_misses;
+	return stats;
+}
+
+//--------------------------------------------------------------------------
+// Block Cache
+//--------------------------------------------------------------------------
+// GDAL drivers issue many small reads (shapefile records, GPKG pages, FlatGeobuf index nodes), which are costly when
+// forwarded one by one to a slow file system. Files opened for reading are read in blocks instead, which are kept in
+// a LRU cache shared by all handles, so that the same file opened by several threads (or queries) is read once.
+
+// The size of a block, and the maximum number of blocks read at once when a file is read sequentially
+static constexpr idx_t BLOCK_SIZE = 64 * 1024;
+static constexpr idx_t MAX_READ_AHEAD_BLOCKS = 16;
+
+using Block = shared_ptr<const string>;
+
+class BlockCache {
+public:
+	Block Get(const string &key) {
+		lock_guard<mutex> guard(lock);
+		auto entry = index.find(key);
+		if (entry == index.end()) {
+			return nullptr;
+		}
+		// Move to the front
+		entries.splice(entries.begin(), entries, entry->second);
+		return entry->second->block;
+	}
+
+	void Put(const string &key, Block block) {
+		lock_guard<mutex> guard(lock);
+		if (block->size() > capacity || index.find(key) != index.end()) {
+			return;
+		}
+		entries.push_front(Entry {key, std::move(block)});
+		index[key] = entries.begin();
+		size += entries.front().block->size();
+		Evict();
+	}
+
+	// Drop the blocks of a file that is written to
+	void Invalidate(const string &path) {
+		lock_guard<mutex> guard(lock);
+		for (auto entry = entries.begin(); entry != entries.end();) {
+			if (StringUtil::StartsWith(entry->key, path + '\0')) {
+				size -= entry->block->size();
+				index.erase(entry->key);
+				entry = entries.erase(entry);
+			} else {
+				entry++;
+			}
+		}
+	}
+
+	void SetCapacity(idx_t capacity_p) {
+		lock_guard<mutex> guard(lock);
+		capacity = capacity_p;
+		Evict();
+	}
+
+private:
+	struct Entry {
+		string key;
+		Block block;
+	};
+
+	void Evict() {
+		while (size > capacity) {
+			auto &entry = entries.back();
+			size -= entry.block->size();
+			index.erase(entry.key);
+			entries.pop_back();
+		}
+	}
+
+	mutex lock;
+	idx_t capacity = GdalFileHandler::DEFAULT_BLOCK_CACHE_SIZE;
+	idx_t size = 0;
+	// Most recently used blocks are at the front
+	std::list<Entry> entries;
+	unordered_map<string, std::list<Entry>::iterator> index;
+};
+
+static BlockCache block_cache;
+
+void GdalFileHandler::RegisterSettings(DatabaseInstance &db) {
+	auto &config = DBConfig::GetConfig(db);
+	config.AddExtensionOption(BLOCK_CACHE_SIZE_SETTING,
+	                          "The size in bytes of the cache of blocks of files read through GDAL (0 to disable)",
+	                          LogicalType::UBIGINT, Value::UBIGINT(DEFAULT_BLOCK_CACHE_SIZE));
+}
+
+// A file opened through GDAL. Files opened for reading are read through the block cache, other files directly.
+struct GdalFile {
+	unique_ptr<FileHandle> handle;
+	bool cached = false;
+	// The path of a file that is written to, of which the cached blocks are dropped once it is closed
+	string path;
+
+	// The position and size of a cached file
+	idx_t position = 0;
+	idx_t file_size = 0;
+	// The blocks are keyed on the path, size and modification time of the file, so that changed files are read again.
+	// The modification time only has a resolution of seconds: a file that is rewritten (by another process) with the
+	// same size within the same second as it was last read is served stale blocks. Files written through GDAL drop
+	// their blocks when they are opened and closed, and SET gdal_block_cache_size = 0 disables the cache altogether.
+	string key_prefix;
+
+	// The current block, and the blocks that were read ahead of it
+	Block block;
+	idx_t block_idx = 0;
+	std::deque<Block> read_ahead;
+	idx_t read_ahead_blocks = 1;
+
+	string BlockKey(idx_t idx) const {
+		return key_prefix + to_string(idx);
+	}
+
+	const string &GetBlock(idx_t idx) {
+		if (block && block_idx == idx) {
+			return *block;
+		}
+		auto sequential = block && idx == block_idx + 1;
+		block_idx = idx;
+
+		// Blocks that were read ahead
+		if (sequential && !read_ahead.empty()) {
+			block = std::move(read_ahead.front());
+			read_ahead.pop_front();
+			cache_hits++;
+			return *block;
+		}
+		read_ahead.clear();
+
+		// Blocks read by another handle
+		block = block_cache.Get(BlockKey(idx));
+		if (block) {
+			cache_hits++;
+			return *block;
+		}
+		cache_misses++;
+
+		// Read more blocks at once as long as the file is read sequentially
+		read_ahead_blocks = sequential ? MinValue<idx_t>(read_ahead_blocks * 2, MAX_READ_AHEAD_BLOCKS) : 1;
+		auto start = idx * BLOCK_SIZE;
+		auto end = MinValue<idx_t>(start + read_ahead_blocks * BLOCK_SIZE, file_size);
+		string buffer(end - start, '\0');
+		handle->Read((void *)buffer.data(), buffer.size(), start);
+		read_count++;
+		bytes_read += buffer.size();
+
+		for (auto offset = start; offset < end; offset += BLOCK_SIZE) {
+			auto data = make_shared<const string>(buffer, offset - start, MinValue<idx_t>(BLOCK_SIZE, end - offset));
+			block_cache.Put(BlockKey(offset / BLOCK_SIZE), data);
+			if (offset == start) {
+				block = std::move(data);
+			} else {
+				read_ahead.push_back(std::move(data));
+			}
+		}
+		return *block;
+	}
+
+	idx_t Read(data_ptr_t buffer, idx_t n_bytes) {
+		if (position >= file_size) {
+			return 0;
+		}
+		n_bytes = MinValue<idx_t>(n_bytes, file_size - position);
+
+		// Reads of more than a few blocks are not worth caching
+		if (n_bytes >= MAX_READ_AHEAD_BLOCKS * BLOCK_SIZE) {
+			handle->Read(buffer, n_bytes, position);
+			read_count++;
+			bytes_read += n_bytes;
+			position += n_bytes;
+			return n_bytes;
+		}
+
+		idx_t total = 0;
+		while (total < n_bytes) {
+			auto idx = position / BLOCK_SIZE;
+			auto &data = GetBlock(idx);
+			auto offset = position - idx * BLOCK_SIZE;
+			if (offset >= data.size()) {
+				// The file is shorter than it was when it was opened
+				break;
+			}
+			auto count = MinValue<idx_t>(n_bytes - total, data.size() - offset);
+			memcpy(buffer + total, data.data() + offset, count);
+			total += count;
+			position += count;
+		}
+		return total;
+	}
+};
+
 //--------------------------------------------------------------------------
 // Required Callbacks
 //--------------------------------------------------------------------------
@@ -68,72 +289,122 @@ static void *DuckDBOpen(void *, const char *file_name, const char *access) {
 
 	try {
 		string path(file_name);
-		auto file = fs.OpenFile(file_name, flags);
-		return file.release();
+		auto result = make_uniq<GdalFile>();
+		result->handle = fs.OpenFile(file_name, flags);
+
+		Value cache_size;
+		if (context.TryGetCurrentSetting(GdalFileHandler::BLOCK_CACHE_SIZE_SETTING, cache_size)) {
+			block_cache.SetCapacity(cache_size.GetValue<uint64_t>());
+		}
+
+		if (flags == FileFlags::FILE_FLAGS_READ && result->handle->CanSeek()) {
+			result->cached = true;
+			result->file_size = result->handle->GetFileSize();
+			// See the caveat of GdalFile::key_prefix
+			auto last_modified = fs.GetLastModifiedTime(*result->handle);
+			result->key_prefix = path + '\0' + to_string(result->file_size) + ":" +
+			                     to_string((int64_t)last_modified) + ":";
+		} else if (flags & FileFlags::FILE_FLAGS_WRITE) {
+			result->path = path;
+			block_cache.Invalidate(path);
+		}
+		return result.release();
 	} catch (std::exception &ex) {
 		return nullptr;
 	}
 }
 
 static vsi_l_offset DuckDBTell(void *file) {
-	auto file_handle = static_cast<FileHandle *>(file);
-	auto offset = file_handle->SeekPosition();
+	auto &gdal_file = *static_cast<GdalFile *>(file);
+	if (gdal_file.cached) {
+		return static_cast<vsi_l_offset>(gdal_file.position);
+	}
+	auto offset = gdal_file.handle->SeekPosition();
 	return static_cast<vsi_l_offset>(offset);
 }
 
 static int DuckDBSeek(void *file, vsi_l_offset offset, int whence) {
-	auto file_handle = static_cast<FileHandle *>(file);
+	auto &gdal_file = *static_cast<GdalFile *>(file);
+	auto file_handle = gdal_file.handle.get();
+	auto position = gdal_file.cached ? gdal_file.position : file_handle->SeekPosition();
+	idx_t new_position;
 	switch (whence) {
 	case SEEK_SET:
-		file_handle->Seek(offset);
+		new_position = offset;
 		break;
 	case SEEK_CUR:
-		file_handle->Seek(file_handle->SeekPosition() + offset);
+		new_position = position + offset;
 		break;
 	case SEEK_END:
-		file_handle->Seek(file_handle->GetFileSize() + offset);
+		// The size of an uncached file may require a stat (or a request), so it is only looked up when needed
+		new_position = (gdal_file.cached ? gdal_file.file_size : file_handle->GetFileSize()) + offset;
 		break;
 	default:
 		throw InternalException("Unknown seek type");
 	}
+	if (new_position != position) {
+		seek_count++;
+	}
+	if (gdal_file.cached) {
+		// Cached files are read at their position, nothing to do until then
+		gdal_file.position = new_position;
+	} else {
+		file_handle->Seek(new_position);
+	}
 	return 0;
 }
 
 static size_t DuckDBRead(void *pFile, void *pBuffer, size_t n_size, size_t n_count) {
-	auto file_handle = static_cast<FileHandle *>(pFile);
-	auto read_bytes = file_handle->Read(pBuffer, n_size * n_count);
+	auto &gdal_file = *static_cast<GdalFile *>(pFile);
+	auto n_bytes = n_size * n_count;
+	bytes_requested += n_bytes;
+	idx_t read_bytes;
+	if (gdal_file.cached) {
+		read_bytes = gdal_file.Read(static_cast<data_ptr_t>(pBuffer), n_bytes);
+	} else {
+		read_bytes = gdal_file.handle->Read(pBuffer, n_bytes);
+		read_count++;
+		bytes_read += read_bytes;
+	}
 	// Return the number of items read
 	return static_cast<size_t>(read_bytes / n_size);
 }
 
 static size_t DuckDBWrite(void *file, const void *buffer, size_t n_size, size_t n_count) {
-	auto file_handle = static_cast<FileHandle *>(file);
+	auto file_handle = static_cast<GdalFile *>(file)->handle.get();
 	auto written_bytes = file_handle->Write(const_cast<void *>(buffer), n_size * n_count);
 	// Return the number of items written
 	return static_cast<size_t>(written_bytes / n_size);
 }
 
 static int DuckDBEoF(void *file) {
+	auto &gdal_file = *static_cast<GdalFile *>(file);
+	if (gdal_file.cached) {
+		return gdal_file.position >= gdal_file.file_size ? TRUE : FALSE;
+	}
 	// TODO: Is this correct?
-	auto file_handle = static_cast<FileHandle *>(file);
+	auto file_handle = gdal_file.handle.get();
 	return file_handle->SeekPosition() == file_handle->GetFileSize() ? TRUE : FALSE;
 }
 
 static int DuckDBTruncate(void *file, vsi_l_offset size) {
-	auto file_handle = static_cast<FileHandle *>(file);
+	auto file_handle = static_cast<GdalFile *>(file)->handle.get();
 	file_handle->Truncate(static_cast<int64_t>(size));
 	return 0;
 }
 
 static int DuckDBClose(void *file) {
-	auto file_handle = static_cast<FileHandle *>(file);
-	file_handle->Close();
-	delete file_handle;
+	auto gdal_file = static_cast<GdalFile *>(file);
+	gdal_file->handle->Close();
+	if (!gdal_file->path.empty()) {
+		block_cache.Invalidate(gdal_file->path);
+	}
+	delete gdal_file;
 	return 0;
 }
 
 static int DuckDBFlush(void *file) {
-	auto file_handle = static_cast<FileHandle *>(file);
+	auto file_handle = static_cast<GdalFile *>(file)->handle.get();
 	file_handle->Sync();
 	return 0;
 }
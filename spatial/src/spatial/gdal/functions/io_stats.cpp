@@ -0,0 +1,71 @@
+#include "duckdb/function/pragma_function.hpp"
+
+#include "spatial/common.hpp"
+#include "spatial/gdal/functions.hpp"
+#include "spatial/gdal/file_handler.hpp"
+
+namespace spatial {
+
+namespace gdal {
+
+//------------------------------------------------------------------------
+// GDAL I/O Statistics
+//------------------------------------------------------------------------
+// Counters of all files that have been read or written through GDAL so far.
+
+struct IOStatsState : public GlobalTableFunctionState {
+	bool done = false;
+};
+
+static unique_ptr<FunctionData> IOStatsBind(ClientContext &context, TableFunctionBindInput &input,
+                                            vector<LogicalType> &return_types, vector<string> &names) {
+	return_types.emplace_back(LogicalType::UBIGINT);
+	return_types.emplace_back(LogicalType::UBIGINT);
+	return_types.emplace_back(LogicalType::UBIGINT);
+	return_types.emplace_back(LogicalType::UBIGINT);
+	return_types.emplace_back(LogicalType::UBIGINT);
+	return_types.emplace_back(LogicalType::UBIGINT);
+	names.emplace_back("bytes_requested");
+	names.emplace_back("bytes_read");
+	names.emplace_back("reads");
+	names.emplace_back("seeks");
+	names.emplace_back("cache_hits");
+	names.emplace_back("cache_misses");
+	return nullptr;
+}
+
+static unique_ptr<GlobalTableFunctionState> IOStatsInit(ClientContext &context, TableFunctionInitInput &input) {
+	return make_uniq<IOStatsState>();
+}
+
+static void IOStatsExecute(ClientContext &context, TableFunctionInput &input, DataChunk &output) {
+	auto &state = input.global_state->Cast<IOStatsState>();
+	if (state.done) {
+		return;
+	}
+	auto stats = GdalFileHandler::GetStats();
+	output.data[0].SetValue(0, Value::UBIGINT(stats.bytes_requested));
+	output.data[1].SetValue(0, Value::UBIGINT(stats.bytes_read));
+	output.data[2].SetValue(0, Value::UBIGINT(stats.reads));
+	output.data[3].SetValue(0, Value::UBIGINT(stats.seeks));
+	output.data[4].SetValue(0, Value::UBIGINT(stats.cache_hits));
+	output.data[5].SetValue(0, Value::UBIGINT(stats.cache_misses));
+	output.SetCardinality(1);
+	state.done = true;
+}
+
+static string IOStatsPragma(ClientContext &context, const FunctionParameters &parameters) {
+	return "SELECT * FROM spatial_gdal_io_stats()";
+}
+
+void GdalIOStatsTableFunction::Register(DatabaseInstance &db) {
+	TableFunction func("spatial_gdal_io_stats", {}, IOStatsExecute, IOStatsBind, IOStatsInit);
+	ExtensionUtil::RegisterFunction(db, func);
+
+	auto pragma = PragmaFunction::PragmaStatement("spatial_gdal_io_stats", IOStatsPragma);
+	ExtensionUtil::RegisterFunction(db, pragma);
+}
+
+} // namespace gdal
+
+} // namespace spatial
@@ -7,14 +7,19 @@
 #include "duckdb/planner/table_filter.hpp"
 #include "duckdb/function/function.hpp"
 #include "duckdb/function/replacement_scan.hpp"
+#include "duckdb/parser/keyword_helper.hpp"
+#include "duckdb/common/multi_file_reader.hpp"
+#include "duckdb/common/case_insensitive_map.hpp"
 
 #include "spatial/common.hpp"
 #include "spatial/core/types.hpp"
+#include "spatial/core/functions/common.hpp"
 #include "spatial/gdal/functions.hpp"
 #include "spatial/gdal/file_handler.hpp"
-#include "spatial/core/geometry/geometry_factory.hpp"
+#include "spatial/core/geometry/wkb_transcoder.hpp"
 
 #include "ogrsf_frmts.h"
+#include "cpl_string.h"
 
 namespace spatial {
 
@@ -95,30 +100,241 @@ static string FilterToGdal(const TableFilterSet &set, const vector<idx_t> &colum
 	return StringUtil::Join(filters, " AND ");
 }
 
+// Decide a filter on a column that has the same value for every row of a file
+static bool ConstantPassesFilter(const TableFilter &filter, const Value &value) {
+	switch (filter.filter_type) {
+	case TableFilterType::CONSTANT_COMPARISON: {
+		auto &constant_filter = (const ConstantFilter &)filter;
+		if (value.IsNull()) {
+			return false;
+		}
+		auto &constant = constant_filter.constant;
+		switch (constant_filter.comparison_type) {
+		case ExpressionType::COMPARE_EQUAL:
+			return value == constant;
+		case ExpressionType::COMPARE_NOTEQUAL:
+			return value != constant;
+		case ExpressionType::COMPARE_LESSTHAN:
+			return value < constant;
+		case ExpressionType::COMPARE_LESSTHANOREQUALTO:
+			return value <= constant;
+		case ExpressionType::COMPARE_GREATERTHAN:
+			return value > constant;
+		case ExpressionType::COMPARE_GREATERTHANOREQUALTO:
+			return value >= constant;
+		default:
+			throw NotImplementedException("ConstantPassesFilter: comparison type not implemented");
+		}
+	}
+	case TableFilterType::CONJUNCTION_AND: {
+		auto &and_filter = (const ConjunctionAndFilter &)filter;
+		for (const auto &child_filter : and_filter.child_filters) {
+			if (!ConstantPassesFilter(*child_filter, value)) {
+				return false;
+			}
+		}
+		return true;
+	}
+	case TableFilterType::CONJUNCTION_OR: {
+		auto &or_filter = (const ConjunctionOrFilter &)filter;
+		for (const auto &child_filter : or_filter.child_filters) {
+			if (ConstantPassesFilter(*child_filter, value)) {
+				return true;
+			}
+		}
+		return false;
+	}
+	case TableFilterType::IS_NOT_NULL: {
+		return !value.IsNull();
+	}
+	case TableFilterType::IS_NULL: {
+		return value.IsNull();
+	}
+	default:
+		throw NotImplementedException("ConstantPassesFilter: filter type not implemented");
+	}
+}
+
+// The feature count and extent of a layer, as far as the driver can provide them without reading the features
+// (e.g. from the GeoPackage metadata tables, a FlatGeobuf header or the shapefile header). These are not guaranteed
+// to be up to date with the features, so they are only used for estimates.
+struct GdalLayerStatistics {
+	bool has_feature_count = false;
+	idx_t feature_count = 0;
+	// The extent of the first geometry field
+	bool has_extent = false;
+	core::BoundingBox extent;
+
+	void Initialize(OGRLayer *layer) {
+		auto count = layer->GetFeatureCount(FALSE);
+		if (count >= 0) {
+			has_feature_count = true;
+			feature_count = (idx_t)count;
+		}
+		OGREnvelope envelope;
+		if (layer->GetLayerDefn()->GetGeomFieldCount() > 0 && layer->GetExtent(&envelope, FALSE) == OGRERR_NONE) {
+			has_extent = true;
+			extent.minx = envelope.MinX;
+			extent.miny = envelope.MinY;
+			extent.maxx = envelope.MaxX;
+			extent.maxy = envelope.MaxY;
+		}
+	}
+
+	// Combine with the statistics of the layer of another file, a statistic is only kept if both have it
+	void Merge(const GdalLayerStatistics &other) {
+		has_feature_count = has_feature_count && other.has_feature_count;
+		feature_count += other.feature_count;
+		has_extent = has_extent && other.has_extent;
+		extent.minx = MinValue(extent.minx, other.extent.minx);
+		extent.miny = MinValue(extent.miny, other.extent.miny);
+		extent.maxx = MaxValue(extent.maxx, other.extent.maxx);
+		extent.maxy = MaxValue(extent.maxy, other.extent.maxy);
+	}
+};
+
 struct GdalScanFunctionData : public TableFunctionData {
 	idx_t layer_idx;
+	// Set if the layer was selected by name, in which case it is looked up by name in every file
+	string layer_name;
 	bool sequential_layer_scan = false;
 	bool keep_wkb = false;
 	unordered_set<idx_t> geometry_column_ids;
 	vector<string> layer_creation_options;
 	unique_ptr<SpatialFilter> spatial_filter;
+	// Set if the spatial filter was derived from the filters of the query, rather than passed as a parameter
+	bool spatial_filter_pushed_down = false;
 	GDALDatasetUniquePtr dataset;
 	idx_t max_threads;
 	// before they are renamed
 	vector<string> all_names;
 	vector<LogicalType> all_types;
+	// after they are renamed
+	vector<string> column_names;
+	// the names of the OGR (geometry) fields behind each column, used to skip the columns that are not projected
+	vector<string> ogr_field_names;
 	atomic<idx_t> lines_read;
 	ArrowTableType arrow_table;
+
+	// The files to scan, and how the columns of each file map onto the columns of the scan
+	vector<string> files;
+	MultiFileReaderOptions file_options;
+	MultiFileReaderBindData reader_bind;
+	// Set if more than one file is scanned, or if columns are added for the file name or hive partitions.
+	// Each thread then scans whole files from its own dataset.
+	bool multi_file = false;
+
+	// The parameters the dataset was opened with, so that it can be opened again by each thread of a parallel scan
+	vector<string> open_options;
+	vector<string> allowed_drivers;
+	vector<string> sibling_files;
+
+	// The statistics of the layer, collected for statistics_file_count of the files at bind time. Unless that is
+	// all of them, the feature count is extrapolated and the extent is unknown.
+	GdalLayerStatistics statistics;
+	idx_t statistics_file_count = 0;
+	bool statistics_complete = false;
+	// Set if the filters of the query can not pass any geometry within the extent of the layer. The extent may be
+	// stale, so the layer is still scanned, this only lowers the estimated cardinality.
+	bool extent_disjoint = false;
+
+	// Set if the layer is scanned in parallel, with each thread reading ranges of FIDs from its own dataset
+	bool parallel_fid_scan = false;
+	string fid_column;
+	int64_t min_fid = 0;
+	int64_t max_fid = 0;
+};
+
+// The columns of a layer, in the order of its arrow stream
+struct GdalLayerSchema {
+	vector<string> names;
+	vector<LogicalType> types;
+	// the names of the attributes before they are renamed, as used in attribute filters
+	vector<string> attribute_names;
+	vector<string> ogr_field_names;
+	vector<unique_ptr<ArrowType>> arrow_types;
+	unordered_set<idx_t> geometry_column_ids;
 };
 
+// The number of FIDs per range in a parallel scan
+static constexpr int64_t FID_RANGE_SIZE = 122880;
+
 struct GdalScanLocalState : ArrowScanLocalState {
-	core::GeometryFactory factory;
-	explicit GdalScanLocalState(unique_ptr<ArrowArrayWrapper> current_chunk, ClientContext &context)
-	    : ArrowScanLocalState(std::move(current_chunk)), factory(BufferAllocator::Get(context)) {
+	vector<ArrowArray *> projected_children;
+
+	// The dataset, layer and stream of the current FID range or file in a parallel scan
+	GDALDatasetUniquePtr dataset;
+	OGRLayer *layer = nullptr;
+	unique_ptr<ArrowArrayStreamWrapper> stream;
+
+	// How the columns of the current file map onto the scanned columns in a multi-file scan
+	MultiFileReaderData reader_data;
+	unique_ptr<ArrowTableType> file_arrow_table;
+	vector<idx_t> file_arrow_child_ids;
+	unordered_set<idx_t> file_geometry_columns;
+	DataChunk file_chunk;
+
+	// The geometries transcoded from the WKB of the geometry columns. The chunk is reset for every scanned chunk,
+	// so that the buffers of its vectors are reused. Maps each scanned column to its vector, if it is a geometry.
+	DataChunk geometries;
+	vector<idx_t> geometry_slots;
+
+	explicit GdalScanLocalState(unique_ptr<ArrowArrayWrapper> current_chunk)
+	    : ArrowScanLocalState(std::move(current_chunk)) {
+	}
+
+	~GdalScanLocalState() override {
+		// Release the arrays before the dataset they were read from
+		chunk.reset();
+		stream.reset();
 	}
 };
 
-struct GdalScanGlobalState : ArrowScanGlobalState {};
+struct GdalScanGlobalState : ArrowScanGlobalState {
+	// The arrow arrays only contain the projected columns, in layer order.
+	// This maps each of the scanned columns to its child array.
+	vector<idx_t> arrow_child_ids;
+
+	// The layer settings and ranges of a parallel scan
+	CPLStringList ignored_fields;
+	string attribute_filter;
+	atomic<idx_t> next_range {0};
+	idx_t range_count = 0;
+
+	// The scanned columns and filters of a multi-file scan, which are mapped onto each file when it is opened
+	vector<column_t> column_ids;
+	TableFilterSet *filters = nullptr;
+	atomic<idx_t> next_file {0};
+};
+
+// Lines up the children of the current arrow array with the scanned columns for the duration of a scan
+struct ProjectedArrowChildren {
+	ArrowArray &array;
+	ArrowArray **original_children;
+	int64_t original_child_count;
+
+	ProjectedArrowChildren(ArrowArray &array, const vector<idx_t> &arrow_child_ids, vector<ArrowArray *> &children)
+	    : array(array), original_children(array.children), original_child_count(array.n_children) {
+		children.resize(arrow_child_ids.size());
+		for (idx_t i = 0; i < arrow_child_ids.size(); i++) {
+			auto child_id = arrow_child_ids[i];
+			if (child_id == DConstants::INVALID_INDEX) {
+				children[i] = nullptr;
+			} else if (child_id < (idx_t)original_child_count) {
+				children[i] = original_children[child_id];
+			} else {
+				throw IOException("Arrow stream is missing projected columns");
+			}
+		}
+		array.children = children.data();
+		array.n_children = (int64_t)children.size();
+	}
+
+	~ProjectedArrowChildren() {
+		array.children = original_children;
+		array.n_children = original_child_count;
+	}
+};
 
 struct ScopedOption {
 	string option;
@@ -139,6 +355,162 @@ struct ScopedOption {
 	}
 };
 
+static GDALDatasetUniquePtr OpenDataset(const GdalScanFunctionData &data, const string &file_name) {
+	CPLStringList open_options;
+	CPLStringList allowed_drivers;
+	CPLStringList sibling_files;
+	for (auto &option : data.open_options) {
+		open_options.AddString(option.c_str());
+	}
+	for (auto &driver : data.allowed_drivers) {
+		allowed_drivers.AddString(driver.c_str());
+	}
+	for (auto &file : data.sibling_files) {
+		sibling_files.AddString(file.c_str());
+	}
+	auto dataset = GDALDatasetUniquePtr(GDALDataset::Open(file_name.c_str(), GDAL_OF_VECTOR | GDAL_OF_VERBOSE_ERROR,
+	                                                      allowed_drivers.List(), open_options.List(),
+	                                                      sibling_files.List()));
+	if (dataset == nullptr) {
+		auto error = string(CPLGetLastErrorMsg());
+		throw IOException("Could not open file: " + file_name + " (" + error + ")");
+	}
+	return dataset;
+}
+
+static OGRLayer *GetLayer(GDALDataset &dataset, const GdalScanFunctionData &data, const string &file_name) {
+	auto layer_idx = (int)data.layer_idx;
+	if (!data.layer_name.empty()) {
+		layer_idx = -1;
+		for (int i = 0; i < dataset.GetLayerCount(); i++) {
+			if (data.layer_name == dataset.GetLayer(i)->GetName()) {
+				layer_idx = i;
+				break;
+			}
+		}
+		if (layer_idx < 0) {
+			throw IOException(StringUtil::Format("Layer '%s' could not be found in file: %s", data.layer_name,
+			                                     file_name));
+		}
+	}
+
+	OGRLayer *layer = nullptr;
+	if (data.sequential_layer_scan) {
+		// Get the layer from the dataset by scanning through the layers
+		for (int i = 0; i < dataset.GetLayerCount(); i++) {
+			layer = dataset.GetLayer(i);
+			if (i == layer_idx) {
+				// desired layer found
+				break;
+			}
+			// else scan through and empty the layer
+			OGRFeature *feature;
+			while ((feature = layer->GetNextFeature()) != nullptr) {
+				OGRFeature::DestroyFeature(feature);
+			}
+		}
+	} else {
+		// Otherwise get the layer directly
+		layer = dataset.GetLayer(layer_idx);
+	}
+	if (!layer) {
+		throw IOException("Could not open layer of file: " + file_name);
+	}
+	return layer;
+}
+
+static void CreateArrowStream(OGRLayer *layer, const GdalScanFunctionData &data, ArrowArrayStreamWrapper &stream) {
+	// set layer options
+	char **lco = nullptr;
+	for (auto &option : data.layer_creation_options) {
+		lco = CSLAddString(lco, option.c_str());
+	}
+	if (!layer->GetArrowStream(&stream.arrow_array_stream, lco)) {
+		CSLDestroy(lco);
+		throw IOException("Could not get arrow stream");
+	}
+	CSLDestroy(lco);
+}
+
+void GdalTableFunction::BindLayerSchema(OGRLayer *layer, const GdalScanFunctionData &data, GdalLayerSchema &result) {
+	ArrowArrayStreamWrapper stream;
+	CreateArrowStream(layer, data, stream);
+
+	ArrowSchemaWrapper schema_wrapper;
+	if (stream.arrow_array_stream.get_schema(&stream.arrow_array_stream, &schema_wrapper.arrow_schema) != 0) {
+		throw IOException("Could not get arrow schema from layer");
+	}
+	auto &schema = schema_wrapper.arrow_schema;
+
+	// The Arrow API will return attributes in this order
+	// 1. FID column
+	// 2. all ogr field attributes
+	// 3. all geometry columns
+
+	auto attribute_count = schema.n_children;
+	auto attributes = schema.children;
+	auto layer_defn = layer->GetLayerDefn();
+	idx_t geometry_field_idx = 0;
+
+	result.attribute_names.reserve(attribute_count + 1);
+	result.names.reserve(attribute_count + 1);
+
+	for (idx_t col_idx = 0; col_idx < (idx_t)attribute_count; col_idx++) {
+		auto &attribute = *attributes[col_idx];
+
+		const char ogc_flag[] = {'\x01', '\0', '\0', '\0', '\x14', '\0', '\0', '\0', 'A', 'R', 'R', 'O', 'W',
+		                         ':',    'e',  'x',  't',  'e',    'n',  's',  'i',  'o', 'n', ':', 'n', 'a',
+		                         'm',    'e',  '\a', '\0', '\0',   '\0', 'o',  'g',  'c', '.', 'w', 'k', 'b'};
+
+		auto arrow_type = GetArrowLogicalType(attribute);
+		auto column_name = string(attribute.name);
+		if (attribute.metadata != nullptr && strncmp(attribute.metadata, ogc_flag, sizeof(ogc_flag)) == 0) {
+			// This is a WKB geometry blob
+			result.arrow_types.push_back(std::move(arrow_type));
+
+			if (data.keep_wkb) {
+				result.types.emplace_back(core::GeoTypes::WKB_BLOB());
+			} else {
+				result.types.emplace_back(core::GeoTypes::GEOMETRY());
+				column_name = "geom";
+			}
+			result.geometry_column_ids.insert(col_idx);
+
+			// The default geometry field may not have a name
+			auto geometry_field_name = geometry_field_idx < (idx_t)layer_defn->GetGeomFieldCount()
+			                               ? string(layer_defn->GetGeomFieldDefn((int)geometry_field_idx)->GetNameRef())
+			                               : string();
+			result.ogr_field_names.push_back(geometry_field_name.empty() && geometry_field_idx == 0
+			                                     ? "OGR_GEOMETRY"
+			                                     : geometry_field_name);
+			geometry_field_idx++;
+
+		} else if (attribute.dictionary) {
+			result.ogr_field_names.push_back(attribute.name);
+			auto dictionary_type = GetArrowLogicalType(attribute);
+			result.types.emplace_back(dictionary_type->GetDuckType());
+			arrow_type->SetDictionary(std::move(dictionary_type));
+			result.arrow_types.push_back(std::move(arrow_type));
+		} else {
+			result.ogr_field_names.push_back(attribute.name);
+			result.types.emplace_back(arrow_type->GetDuckType());
+			result.arrow_types.push_back(std::move(arrow_type));
+		}
+
+		// keep these around for projection/filter pushdown later
+		// does GDAL even allow duplicate/missing names?
+		result.attribute_names.push_back(column_name);
+
+		if (column_name.empty()) {
+			result.names.push_back("v" + to_string(col_idx));
+		} else {
+			result.names.push_back(column_name);
+		}
+	}
+
+	GdalTableFunction::RenameColumns(result.names);
+}
+
 //------------------------------------------------------------------------------
 // Bind
 //------------------------------------------------------------------------------
@@ -153,82 +525,72 @@ unique_ptr<FunctionData> GdalTableFunction::Bind(ClientContext &context, TableFu
 	// Set the local client context so that we can access it from the filesystem handler
 	GdalFileHandler::SetLocalClientContext(context);
 
+	auto result = make_uniq<GdalScanFunctionData>();
+
 	// First scan for "options" parameter
-	auto gdal_open_options = vector<char const *>();
 	auto options_param = input.named_parameters.find("open_options");
 	if (options_param != input.named_parameters.end()) {
 		for (auto &param : ListValue::GetChildren(options_param->second)) {
-			gdal_open_options.push_back(StringValue::Get(param).c_str());
+			result->open_options.push_back(StringValue::Get(param));
 		}
 	}
-	if (!gdal_open_options.empty()) {
-		gdal_open_options.push_back(nullptr);
-	}
 
-	auto gdal_allowed_drivers = vector<char const *>();
 	auto drivers_param = input.named_parameters.find("allowed_drivers");
 	if (drivers_param != input.named_parameters.end()) {
 		for (auto &param : ListValue::GetChildren(drivers_param->second)) {
-			gdal_allowed_drivers.push_back(StringValue::Get(param).c_str());
+			result->allowed_drivers.push_back(StringValue::Get(param));
 		}
 	}
-	if (!gdal_allowed_drivers.empty()) {
-		gdal_allowed_drivers.push_back(nullptr);
-	}
 
-	auto gdal_sibling_files = vector<char const *>();
 	auto siblings_params = input.named_parameters.find("sibling_files");
 	if (siblings_params != input.named_parameters.end()) {
-		for (auto &param : ListValue::GetChildren(drivers_param->second)) {
-			gdal_sibling_files.push_back(StringValue::Get(param).c_str());
+		for (auto &param : ListValue::GetChildren(siblings_params->second)) {
+			result->sibling_files.push_back(StringValue::Get(param));
 		}
 	}
-	if (!gdal_sibling_files.empty()) {
-		gdal_sibling_files.push_back(nullptr);
-	}
 
 	// HACK: check for XLSX_HEADERS open option
 	// TODO: Remove this once GDAL 3.8 is released
 	ScopedOption xlsx_headers("OGR_XLSX_HEADERS", "AUTO");
 	ScopedOption xlsx_field_types("OGR_XLSX_FIELD_TYPES", "AUTO");
-	for (auto &option : gdal_open_options) {
-		if (option == nullptr) {
-			break;
-		} else if (strcmp(option, "HEADERS=FORCE") == 0) {
+	for (auto &option : result->open_options) {
+		if (option == "HEADERS=FORCE") {
 			xlsx_headers.Set("FORCE");
-		} else if (strcmp(option, "HEADERS=DISABLE") == 0) {
+		} else if (option == "HEADERS=DISABLE") {
 			xlsx_headers.Set("DISABLE");
-		} else if (strcmp(option, "HEADERS=AUTO") == 0) {
+		} else if (option == "HEADERS=AUTO") {
 			xlsx_headers.Set("AUTO");
-		} else if (strcmp(option, "FIELD_TYPES=STRING") == 0) {
+		} else if (option == "FIELD_TYPES=STRING") {
 			xlsx_field_types.Set("STRING");
-		} else if (strcmp(option, "FIELD_TYPES=AUTO") == 0) {
+		} else if (option == "FIELD_TYPES=AUTO") {
 			xlsx_field_types.Set("AUTO");
 		}
 	}
 
-	// Now we can open the dataset
-	auto file_name = input.inputs[0].GetValue<string>();
-	auto dataset =
-	    GDALDatasetUniquePtr(GDALDataset::Open(file_name.c_str(), GDAL_OF_VECTOR | GDAL_OF_VERBOSE_ERROR,
-	                                           gdal_allowed_drivers.empty() ? nullptr : gdal_allowed_drivers.data(),
-	                                           gdal_open_options.empty() ? nullptr : gdal_open_options.data(),
-	                                           gdal_sibling_files.empty() ? nullptr : gdal_sibling_files.data()));
-
-	if (dataset == nullptr) {
-		auto error = string(CPLGetLastErrorMsg());
-		throw IOException("Could not open file: " + file_name + " (" + error + ")");
+	// A single path is passed to GDAL as is, as it does not have to be a file (e.g. a database connection string).
+	// Globs and lists of files are expanded on the DuckDB file system.
+	auto &input_value = input.inputs[0];
+	if (input_value.type().id() == LogicalTypeId::VARCHAR && !FileSystem::HasGlob(StringValue::Get(input_value))) {
+		result->files.push_back(StringValue::Get(input_value));
+	} else {
+		result->files = MultiFileReader::GetFileList(context, input_value, "ST_Read");
 	}
 
+	// Now we can open the (first) dataset
+	auto &file_name = result->files[0];
+	auto dataset = OpenDataset(*result, file_name);
+
 	// Double check that the dataset have any layers
 	if (dataset->GetLayerCount() <= 0) {
 		throw IOException("Dataset does not contain any layers");
 	}
 
 	// Now we can bind the additonal options
-	auto result = make_uniq<GdalScanFunctionData>();
 	bool max_batch_size_set = false;
 	for (auto &kv : input.named_parameters) {
+		if (MultiFileReader::ParseOption(kv.first, kv.second, result->file_options, context)) {
+			continue;
+		}
 		auto loption = StringUtil::Lower(kv.first);
 		if (loption == "layer") {
 
@@ -252,6 +614,7 @@ unique_ptr<FunctionData> GdalTableFunction::Bind(ClientContext &context, TableFu
 				for (auto layer_idx = 0; layer_idx < dataset->GetLayerCount(); layer_idx++) {
 					if (strcmp(dataset->GetLayer(layer_idx)->GetName(), name) == 0) {
 						result->layer_idx = (idx_t)layer_idx;
+						result->layer_name = name;
 						found = true;
 						break;
 					}
@@ -307,6 +670,7 @@ unique_ptr<FunctionData> GdalTableFunction::Bind(ClientContext &context, TableFu
 			result->keep_wkb = BooleanValue::Get(kv.second);
 		}
 	}
+	result->file_options.AutoDetectHivePartitioning(result->files, context);
 
 	// set default max_threads
 	if (result->max_threads == 0) {
@@ -320,88 +684,110 @@ unique_ptr<FunctionData> GdalTableFunction::Bind(ClientContext &context, TableFu
 		result->layer_creation_options.push_back(StringUtil::Format("MAX_FEATURES_IN_BATCH=%d", STANDARD_VECTOR_SIZE));
 	}
 
-	// set layer options
-	char **lco = nullptr;
-	for (auto &option : result->layer_creation_options) {
-		lco = CSLAddString(lco, option.c_str());
-	}
-
 	// Get the schema for the selected layer
 	auto layer = dataset->GetLayer(result->layer_idx);
-	struct ArrowArrayStream stream;
-	if (!layer->GetArrowStream(&stream, lco)) {
-		// layer is owned by GDAL, we do not need to destory it
-		CSLDestroy(lco);
-		throw IOException("Could not get arrow stream from layer");
+	GdalLayerSchema schema;
+	BindLayerSchema(layer, *result, schema);
+
+	names = schema.names;
+	return_types = schema.types;
+	result->all_names = schema.attribute_names;
+	result->ogr_field_names = schema.ogr_field_names;
+	result->geometry_column_ids = schema.geometry_column_ids;
+	for (idx_t col_idx = 0; col_idx < schema.arrow_types.size(); col_idx++) {
+		result->arrow_table.AddColumn(col_idx, std::move(schema.arrow_types[col_idx]));
 	}
-	CSLDestroy(lco);
+	auto layer_column_count = names.size();
 
-	struct ArrowSchema schema;
-	if (stream.get_schema(&stream, &schema) != 0) {
-		if (stream.release) {
-			stream.release(&stream);
-		}
-		throw IOException("Could not get arrow schema from layer");
+	// Collect the statistics the planner can use, as far as they are available without reading the layer.
+	// Counting the features of a sequentially scanned layer would mean reading through the layers twice.
+	if (!result->sequential_layer_scan) {
+		result->statistics.Initialize(layer);
+		result->statistics_file_count = 1;
 	}
 
-	// The Arrow API will return attributes in this order
-	// 1. FID column
-	// 2. all ogr field attributes
-	// 3. all geometry columns
-
-	auto attribute_count = schema.n_children;
-	auto attributes = schema.children;
-
-	result->all_names.reserve(attribute_count + 1);
-	names.reserve(attribute_count + 1);
-
-	for (idx_t col_idx = 0; col_idx < (idx_t)attribute_count; col_idx++) {
-		auto &attribute = *attributes[col_idx];
-
-		const char ogc_flag[] = {'\x01', '\0', '\0', '\0', '\x14', '\0', '\0', '\0', 'A', 'R', 'R', 'O', 'W',
-		                         ':',    'e',  'x',  't',  'e',    'n',  's',  'i',  'o', 'n', ':', 'n', 'a',
-		                         'm',    'e',  '\a', '\0', '\0',   '\0', 'o',  'g',  'c', '.', 'w', 'k', 'b'};
-
-		auto arrow_type = GetArrowLogicalType(attribute);
-		auto column_name = string(attribute.name);
-		if (attribute.metadata != nullptr && strncmp(attribute.metadata, ogc_flag, sizeof(ogc_flag)) == 0) {
-			// This is a WKB geometry blob
-			result->arrow_table.AddColumn(col_idx, std::move(arrow_type));
-
-			if (result->keep_wkb) {
-				return_types.emplace_back(core::GeoTypes::WKB_BLOB());
-			} else {
-				return_types.emplace_back(core::GeoTypes::GEOMETRY());
-				column_name = "geom";
+	if (result->file_options.union_by_name) {
+		// Add the columns of the other files that are not in the first file
+		case_insensitive_map_t<idx_t> name_map;
+		for (idx_t col_idx = 0; col_idx < names.size(); col_idx++) {
+			name_map[names[col_idx]] = col_idx;
+		}
+		for (idx_t file_idx = 1; file_idx < result->files.size(); file_idx++) {
+			auto &other_file_name = result->files[file_idx];
+			auto other_dataset = OpenDataset(*result, other_file_name);
+			auto other_layer = GetLayer(*other_dataset, *result, other_file_name);
+			GdalLayerSchema other_schema;
+			BindLayerSchema(other_layer, *result, other_schema);
+			if (!result->sequential_layer_scan) {
+				GdalLayerStatistics other_statistics;
+				other_statistics.Initialize(other_layer);
+				result->statistics.Merge(other_statistics);
+				result->statistics_file_count++;
 			}
-			result->geometry_column_ids.insert(col_idx);
 
-		} else if (attribute.dictionary) {
-			auto dictionary_type = GetArrowLogicalType(attribute);
-			return_types.emplace_back(dictionary_type->GetDuckType());
-			arrow_type->SetDictionary(std::move(dictionary_type));
-			result->arrow_table.AddColumn(col_idx, std::move(arrow_type));
-		} else {
-			return_types.emplace_back(arrow_type->GetDuckType());
-			result->arrow_table.AddColumn(col_idx, std::move(arrow_type));
+			for (idx_t col_idx = 0; col_idx < other_schema.names.size(); col_idx++) {
+				auto &name = other_schema.names[col_idx];
+				auto &type = other_schema.types[col_idx];
+				auto is_geometry = other_schema.geometry_column_ids.count(col_idx) != 0;
+				auto entry = name_map.find(name);
+				if (entry == name_map.end()) {
+					name_map[name] = names.size();
+					if (is_geometry) {
+						result->geometry_column_ids.insert(names.size());
+					}
+					names.push_back(name);
+					return_types.push_back(type);
+					result->all_names.push_back(other_schema.attribute_names[col_idx]);
+					continue;
+				}
+				auto &union_type = return_types[entry->second];
+				if (union_type == type) {
+					continue;
+				}
+				if (is_geometry || result->geometry_column_ids.count(entry->second) != 0) {
+					throw BinderException(StringUtil::Format("Column \"%s\" has incompatible types in \"%s\" and \"%s\"",
+					                                         name, file_name, other_file_name));
+				}
+				union_type = LogicalType::MaxLogicalType(union_type, type);
+			}
 		}
+	}
 
-		// keep these around for projection/filter pushdown later
-		// does GDAL even allow duplicate/missing names?
-		result->all_names.push_back(column_name);
+	// Add the file name and hive partitioning columns, if requested
+	result->reader_bind = MultiFileReader::BindOptions(result->file_options, result->files, return_types, names);
+	for (idx_t col_idx = result->all_names.size(); col_idx < names.size(); col_idx++) {
+		result->all_names.push_back(names[col_idx]);
+	}
+	result->column_names = names;
+	result->multi_file = result->files.size() > 1 || names.size() > layer_column_count;
+	result->statistics_complete = result->statistics_file_count == result->files.size();
+	if (!result->statistics_complete) {
+		result->statistics.has_extent = false;
+	}
 
-		if (column_name.empty()) {
-			names.push_back("v" + to_string(col_idx));
-		} else {
-			names.push_back(column_name);
+	// GeoPackage layers are scanned in parallel over ranges of FIDs. The FID is the primary key of the table,
+	// so each range is an index lookup.
+	auto fid_column = string(layer->GetFIDColumn());
+	if (!result->multi_file && !result->sequential_layer_scan && result->max_threads > 1 && !fid_column.empty() &&
+	    StringUtil::CIEquals(dataset->GetDriverName(), "GPKG")) {
+		auto quoted_fid = KeywordHelper::WriteQuoted(fid_column, '"');
+		auto sql = StringUtil::Format("SELECT MIN(%s), MAX(%s) FROM %s", quoted_fid, quoted_fid,
+		                              KeywordHelper::WriteQuoted(layer->GetName(), '"'));
+		auto sql_layer = dataset->ExecuteSQL(sql.c_str(), nullptr, nullptr);
+		if (sql_layer) {
+			auto feature = OGRFeatureUniquePtr(sql_layer->GetNextFeature());
+			if (feature && feature->IsFieldSetAndNotNull(0) && feature->IsFieldSetAndNotNull(1)) {
+				result->min_fid = feature->GetFieldAsInteger64(0);
+				result->max_fid = feature->GetFieldAsInteger64(1);
+				// Not worth it for a single range
+				result->parallel_fid_scan = result->max_fid - result->min_fid >= FID_RANGE_SIZE;
+				result->fid_column = fid_column;
+			}
+			feature.reset();
+			dataset->ReleaseResultSet(sql_layer);
 		}
 	}
 
-	schema.release(&schema);
-	stream.release(&stream);
-
-	GdalTableFunction::RenameColumns(names);
-
 	result->dataset = std::move(dataset);
 	result->all_types = return_types;
 
@@ -437,30 +823,7 @@ idx_t GdalTableFunction::MaxThreads(ClientContext &context, const FunctionData *
 	return data->max_threads;
 }
 
-OGRLayer *open_layer(const GdalScanFunctionData &data) {
-
-	// Get selected layer
-	OGRLayer *layer = nullptr;
-	if (data.sequential_layer_scan) {
-		// Get the layer from the dataset by scanning through the layers
-		for (int i = 0; i < data.dataset->GetLayerCount(); i++) {
-			layer = data.dataset->GetLayer(i);
-			if (i == (int)data.layer_idx) {
-				// desired layer found
-				break;
-			}
-			// else scan through and empty the layer
-			OGRFeature *feature;
-			while ((feature = layer->GetNextFeature()) != nullptr) {
-				OGRFeature::DestroyFeature(feature);
-			}
-		}
-	} else {
-		// Otherwise get the layer directly
-		layer = data.dataset->GetLayer(data.layer_idx);
-	}
-
-	// Apply spatial filter (if we got one)
+static void SetLayerSpatialFilter(OGRLayer *layer, const GdalScanFunctionData &data) {
 	if (data.spatial_filter != nullptr) {
 		if (data.spatial_filter->type == SpatialFilterType::Rectangle) {
 			auto &rect = (RectangleSpatialFilter &)*data.spatial_filter;
@@ -470,6 +833,15 @@ OGRLayer *open_layer(const GdalScanFunctionData &data) {
 			layer->SetSpatialFilter(OGRGeometry::FromHandle(filter.geom));
 		}
 	}
+}
+
+OGRLayer *open_layer(const GdalScanFunctionData &data) {
+
+	// Get selected layer
+	auto layer = GetLayer(*data.dataset, data, data.files[0]);
+
+	// Apply spatial filter (if we got one)
+	SetLayerSpatialFilter(layer, data);
 
 	return layer;
 }
@@ -481,33 +853,69 @@ unique_ptr<GlobalTableFunctionState> GdalTableFunction::InitGlobal(ClientContext
                                                                    TableFunctionInitInput &input) {
 	auto &data = input.bind_data->Cast<GdalScanFunctionData>();
 	auto global_state = make_uniq<GdalScanGlobalState>();
+	global_state->max_threads = GdalTableFunction::MaxThreads(context, input.bind_data.get());
 
-	auto layer = open_layer(data);
-	// TODO: Apply projection pushdown
-
-	// Apply predicate pushdown
-	// We simply create a string out of the predicates and pass it to GDAL.
-	if (input.filters) {
-		auto filter_clause = FilterToGdal(*input.filters, input.column_ids, data.all_names);
-		layer->SetAttributeFilter(filter_clause.c_str());
-	}
+	if (data.multi_file) {
+		// Each thread opens the files it scans, projection and predicate pushdown are applied per file
+		global_state->column_ids = input.column_ids;
+		global_state->filters = input.filters.get();
+		global_state->max_threads = MinValue<idx_t>(global_state->max_threads, data.files.size());
+	} else {
+		auto layer = open_layer(data);
+
+		// Apply projection pushdown
+		// The fields that are not projected are ignored, so that OGR does not read them and leaves them out of the
+		// stream.
+		vector<idx_t> projected_ids;
+		for (auto &col_idx : input.column_ids) {
+			if (col_idx != COLUMN_IDENTIFIER_ROW_ID) {
+				projected_ids.push_back(col_idx);
+			}
+		}
+		std::sort(projected_ids.begin(), projected_ids.end());
+		projected_ids.erase(std::unique(projected_ids.begin(), projected_ids.end()), projected_ids.end());
 
-	// Create arrow stream from layer
+		CPLStringList ignored_fields;
+		for (idx_t col_idx = 0; col_idx < data.ogr_field_names.size(); col_idx++) {
+			if (!std::binary_search(projected_ids.begin(), projected_ids.end(), col_idx)) {
+				ignored_fields.AddString(data.ogr_field_names[col_idx].c_str());
+			}
+		}
+		auto projected = layer->SetIgnoredFields(const_cast<const char **>(ignored_fields.List())) == OGRERR_NONE;
+		if (!projected) {
+			// Read all the fields instead
+			layer->SetIgnoredFields(nullptr);
+		}
+		for (auto &col_idx : input.column_ids) {
+			if (col_idx == COLUMN_IDENTIFIER_ROW_ID) {
+				global_state->arrow_child_ids.push_back(DConstants::INVALID_INDEX);
+			} else if (projected) {
+				auto position = std::lower_bound(projected_ids.begin(), projected_ids.end(), col_idx);
+				global_state->arrow_child_ids.push_back(position - projected_ids.begin());
+			} else {
+				global_state->arrow_child_ids.push_back(col_idx);
+			}
+		}
 
-	global_state->stream = make_uniq<ArrowArrayStreamWrapper>();
+		// Apply predicate pushdown
+		// We simply create a string out of the predicates and pass it to GDAL.
+		if (input.filters) {
+			global_state->attribute_filter = FilterToGdal(*input.filters, input.column_ids, data.all_names);
+			layer->SetAttributeFilter(global_state->attribute_filter.c_str());
+		}
 
-	// set layer options
-	char **lco = nullptr;
-	for (auto &option : data.layer_creation_options) {
-		lco = CSLAddString(lco, option.c_str());
-	}
-	if (!layer->GetArrowStream(&global_state->stream->arrow_array_stream, lco)) {
-		CSLDestroy(lco);
-		throw IOException("Could not get arrow stream");
+		if (data.parallel_fid_scan) {
+			// Each thread opens its own dataset and creates a stream per range
+			if (projected) {
+				global_state->ignored_fields = ignored_fields;
+			}
+			global_state->range_count = (idx_t)((data.max_fid - data.min_fid) / FID_RANGE_SIZE + 1);
+		} else {
+			// Create arrow stream from layer
+			global_state->stream = make_uniq<ArrowArrayStreamWrapper>();
+			CreateArrowStream(layer, data, *global_state->stream);
+		}
 	}
-	CSLDestroy(lco);
-
-	global_state->max_threads = GdalTableFunction::MaxThreads(context, input.bind_data.get());
 
 	if (input.CanRemoveFilterColumns()) {
 		global_state->projection_ids = input.projection_ids;
@@ -523,6 +931,211 @@ unique_ptr<GlobalTableFunctionState> GdalTableFunction::InitGlobal(ClientContext
 	return std::move(global_state);
 }
 
+//-----------------------------------------------------------------------------
+// Parallel Scan
+//-----------------------------------------------------------------------------
+// Move on to the next non-empty chunk of the stream of the local state, if it has one
+static bool LocalStreamNext(GdalScanLocalState &state) {
+	while (state.stream) {
+		auto current_chunk = state.stream->GetNextChunk();
+		if (!current_chunk->arrow_array.release) {
+			state.stream.reset();
+			return false;
+		}
+		if (current_chunk->arrow_array.length == 0) {
+			continue;
+		}
+		state.Reset();
+		state.chunk = std::move(current_chunk);
+		return true;
+	}
+	return false;
+}
+
+// Move on to the next chunk of the current FID range, or to the next range once it is exhausted.
+// All chunks of a range share the same batch index, so that the insertion order can be preserved.
+static bool ParallelRangeNext(ClientContext &context, const GdalScanFunctionData &data, GdalScanLocalState &state,
+                              GdalScanGlobalState &global_state) {
+	GdalFileHandler::SetLocalClientContext(context);
+	while (true) {
+		if (LocalStreamNext(state)) {
+			return true;
+		}
+
+		auto range_idx = global_state.next_range++;
+		if (range_idx >= global_state.range_count) {
+			return false;
+		}
+
+		if (!state.dataset) {
+			state.dataset = OpenDataset(data, data.files[0]);
+			state.layer = GetLayer(*state.dataset, data, data.files[0]);
+			state.layer->SetIgnoredFields(const_cast<const char **>(global_state.ignored_fields.List()));
+			SetLayerSpatialFilter(state.layer, data);
+		}
+
+		auto range_start = data.min_fid + (int64_t)range_idx * FID_RANGE_SIZE;
+		auto fid_column = KeywordHelper::WriteQuoted(data.fid_column, '"');
+		auto range_filter = StringUtil::Format("%s >= %d AND %s < %d", fid_column, range_start, fid_column,
+		                                       range_start + FID_RANGE_SIZE);
+		if (!global_state.attribute_filter.empty()) {
+			range_filter += " AND (" + global_state.attribute_filter + ")";
+		}
+		if (state.layer->SetAttributeFilter(range_filter.c_str()) != OGRERR_NONE) {
+			throw IOException("Could not set attribute filter: " + range_filter);
+		}
+
+		state.batch_index = range_idx;
+		state.stream = make_uniq<ArrowArrayStreamWrapper>();
+		CreateArrowStream(state.layer, data, *state.stream);
+	}
+}
+
+// Open a file of a multi-file scan, and map its columns onto the scanned columns.
+// Returns false if the file can be skipped, as no row can pass the filters on its constant columns.
+static bool InitializeFile(ClientContext &context, const GdalScanFunctionData &data, GdalScanLocalState &state,
+                           GdalScanGlobalState &global_state, idx_t file_idx) {
+	auto &file_name = data.files[file_idx];
+	state.dataset = OpenDataset(data, file_name);
+	state.layer = GetLayer(*state.dataset, data, file_name);
+
+	GdalLayerSchema schema;
+	GdalTableFunction::BindLayerSchema(state.layer, data, schema);
+
+	// Columns that are not in the file, the file name and the hive partitions are constant for the whole file
+	auto &reader_data = state.reader_data;
+	reader_data = MultiFileReaderData();
+	MultiFileReader::FinalizeBind(data.file_options, data.reader_bind, file_name, schema.names, data.all_types,
+	                              data.column_names, global_state.column_ids, reader_data, context);
+	MultiFileReader::CreateMapping(file_name, schema.types, schema.names, data.all_types, data.column_names,
+	                               global_state.column_ids, global_state.filters, reader_data, data.files.front());
+
+	// Filters on the constant columns are decided here, the others are passed on to OGR
+	vector<string> attribute_filters;
+	if (global_state.filters) {
+		for (auto &entry : global_state.filters->filters) {
+			auto constant = std::find_if(
+			    reader_data.constant_map.begin(), reader_data.constant_map.end(),
+			    [&](const MultiFileConstantEntry &constant_entry) { return constant_entry.column_id == entry.first; });
+			if (constant != reader_data.constant_map.end()) {
+				if (!ConstantPassesFilter(*entry.second, constant->value)) {
+					return false;
+				}
+				continue;
+			}
+			auto mapping = std::find(reader_data.column_mapping.begin(), reader_data.column_mapping.end(), entry.first);
+			D_ASSERT(mapping != reader_data.column_mapping.end());
+			auto local_idx = reader_data.column_ids[mapping - reader_data.column_mapping.begin()];
+			attribute_filters.push_back(FilterToGdal(*entry.second, schema.attribute_names[local_idx]));
+		}
+	}
+
+	// Apply projection pushdown
+	vector<idx_t> projected_ids(reader_data.column_ids.begin(), reader_data.column_ids.end());
+	std::sort(projected_ids.begin(), projected_ids.end());
+	CPLStringList ignored_fields;
+	for (idx_t col_idx = 0; col_idx < schema.ogr_field_names.size(); col_idx++) {
+		if (!std::binary_search(projected_ids.begin(), projected_ids.end(), col_idx)) {
+			ignored_fields.AddString(schema.ogr_field_names[col_idx].c_str());
+		}
+	}
+	auto projected = state.layer->SetIgnoredFields(const_cast<const char **>(ignored_fields.List())) == OGRERR_NONE;
+	if (!projected) {
+		state.layer->SetIgnoredFields(nullptr);
+	}
+
+	// The columns of the file are converted into a chunk of their own, in the order they are scanned.
+	// The arrow types are keyed on that position, which is also what the column ids of the local state refer to.
+	state.file_arrow_table = make_uniq<ArrowTableType>();
+	state.file_arrow_child_ids.clear();
+	state.file_geometry_columns.clear();
+	state.column_ids.clear();
+	vector<LogicalType> file_types;
+	for (idx_t i = 0; i < reader_data.column_ids.size(); i++) {
+		auto local_idx = reader_data.column_ids[i];
+		if (projected) {
+			auto position = std::lower_bound(projected_ids.begin(), projected_ids.end(), local_idx);
+			state.file_arrow_child_ids.push_back(position - projected_ids.begin());
+		} else {
+			state.file_arrow_child_ids.push_back(local_idx);
+		}
+		state.file_arrow_table->AddColumn(i, std::move(schema.arrow_types[local_idx]));
+		if (schema.geometry_column_ids.count(local_idx) != 0) {
+			state.file_geometry_columns.insert(i);
+		}
+		state.column_ids.push_back(i);
+		file_types.push_back(schema.types[local_idx]);
+	}
+	state.file_chunk.Destroy();
+	if (!file_types.empty()) {
+		state.file_chunk.Initialize(Allocator::Get(context), file_types);
+	}
+	// Dictionaries are cached per column, and differ between files
+	state.array_states.clear();
+
+	// A pushed down spatial filter only applies if the first geometry field of the file is the filtered column
+	auto apply_spatial_filter = !data.spatial_filter_pushed_down;
+	if (data.spatial_filter_pushed_down && !schema.geometry_column_ids.empty()) {
+		auto global_idx = *std::min_element(data.geometry_column_ids.begin(), data.geometry_column_ids.end());
+		auto local_idx = *std::min_element(schema.geometry_column_ids.begin(), schema.geometry_column_ids.end());
+		apply_spatial_filter = StringUtil::CIEquals(data.column_names[global_idx], schema.names[local_idx]);
+	}
+	if (apply_spatial_filter) {
+		SetLayerSpatialFilter(state.layer, data);
+	}
+
+	if (!attribute_filters.empty()) {
+		auto attribute_filter = StringUtil::Join(attribute_filters, " AND ");
+		if (state.layer->SetAttributeFilter(attribute_filter.c_str()) != OGRERR_NONE) {
+			throw IOException("Could not set attribute filter: " + attribute_filter);
+		}
+	}
+
+	state.batch_index = file_idx;
+	state.stream = make_uniq<ArrowArrayStreamWrapper>();
+	CreateArrowStream(state.layer, data, *state.stream);
+	return true;
+}
+
+// Move on to the next chunk of the current file, or to the next file once it is exhausted.
+// All chunks of a file share the same batch index, so that the insertion order can be preserved.
+static bool MultiFileNext(ClientContext &context, const GdalScanFunctionData &data, GdalScanLocalState &state,
+                          GdalScanGlobalState &global_state) {
+	GdalFileHandler::SetLocalClientContext(context);
+	while (true) {
+		if (LocalStreamNext(state)) {
+			return true;
+		}
+
+		auto file_idx = global_state.next_file++;
+		if (file_idx >= data.files.size()) {
+			return false;
+		}
+
+		// Release the arrays of the previous file before closing it
+		state.chunk = make_uniq<ArrowArrayWrapper>();
+		state.stream.reset();
+		state.dataset.reset();
+		state.layer = nullptr;
+
+		if (!InitializeFile(context, data, state, global_state, file_idx)) {
+			// No row of this file can pass the filters
+			continue;
+		}
+	}
+}
+
+static bool ScanNext(ClientContext &context, const GdalScanFunctionData &data, GdalScanLocalState &state,
+                     GdalScanGlobalState &global_state) {
+	if (data.multi_file) {
+		return MultiFileNext(context, data, state, global_state);
+	}
+	if (data.parallel_fid_scan) {
+		return ParallelRangeNext(context, data, state, global_state);
+	}
+	return ArrowTableFunction::ArrowScanParallelStateNext(context, &data, state, global_state);
+}
+
 //-----------------------------------------------------------------------------
 // Init Local
 //-----------------------------------------------------------------------------
@@ -531,16 +1144,31 @@ unique_ptr<LocalTableFunctionState> GdalTableFunction::InitLocal(ExecutionContex
                                                                  GlobalTableFunctionState *global_state_p) {
 	GdalFileHandler::SetLocalClientContext(context.client);
 
-	auto &global_state = global_state_p->Cast<ArrowScanGlobalState>();
+	auto &data = input.bind_data->Cast<GdalScanFunctionData>();
+	auto &global_state = global_state_p->Cast<GdalScanGlobalState>();
 	auto current_chunk = make_uniq<ArrowArrayWrapper>();
-	auto result = make_uniq<GdalScanLocalState>(std::move(current_chunk), context.client);
+	auto result = make_uniq<GdalScanLocalState>(std::move(current_chunk));
 	result->column_ids = input.column_ids;
 	result->filters = input.filters.get();
 	if (input.CanRemoveFilterColumns()) {
 		result->all_columns.Initialize(context.client, global_state.scanned_types);
 	}
+	if (!data.keep_wkb) {
+		vector<LogicalType> geometry_types;
+		for (auto &col_id : input.column_ids) {
+			if (data.geometry_column_ids.count(col_id) != 0) {
+				result->geometry_slots.push_back(geometry_types.size());
+				geometry_types.push_back(core::GeoTypes::GEOMETRY());
+			} else {
+				result->geometry_slots.push_back(DConstants::INVALID_INDEX);
+			}
+		}
+		if (!geometry_types.empty()) {
+			result->geometries.Initialize(context.client, geometry_types);
+		}
+	}
 
-	if (!ArrowScanParallelStateNext(context.client, input.bind_data.get(), *result, global_state)) {
+	if (!ScanNext(context.client, data, *result, global_state)) {
 		return nullptr;
 	}
 
@@ -550,6 +1178,55 @@ unique_ptr<LocalTableFunctionState> GdalTableFunction::InitLocal(ExecutionContex
 //-----------------------------------------------------------------------------
 // Scan
 //-----------------------------------------------------------------------------
+// Convert a column of WKB blobs to a column of geometries, transcoded into a vector of the local state
+static void ConvertWKB(Vector &wkb_vec, Vector &geom_vec, idx_t count) {
+	UnaryExecutor::Execute<string_t, string_t>(wkb_vec, geom_vec, count, [&](string_t input) {
+		return core::WKBTranscoder::Transcode(geom_vec, input.GetDataUnsafe(), input.GetSize());
+	});
+	wkb_vec.ReferenceAndSetType(geom_vec);
+}
+
+// Convert the current chunk of a file in a multi-file scan, and line its columns up with the scanned columns
+static void ScanFileColumns(ClientContext &context, const GdalScanFunctionData &data, GdalScanLocalState &state,
+                            DataChunk &output, idx_t start) {
+	auto &reader_data = state.reader_data;
+	auto count = output.size();
+	if (!reader_data.column_ids.empty()) {
+		state.file_chunk.Reset();
+		state.file_chunk.SetCardinality(count);
+		ProjectedArrowChildren children(state.chunk->arrow_array, state.file_arrow_child_ids,
+		                                state.projected_children);
+		ArrowToDuckDB(state, state.file_arrow_table->GetColumns(), state.file_chunk, start, true);
+	}
+
+	for (idx_t i = 0; i < reader_data.column_ids.size(); i++) {
+		auto &source = state.file_chunk.data[i];
+		auto col_idx = reader_data.column_mapping[i];
+		auto &target = output.data[col_idx];
+		if (state.file_geometry_columns.count(i) != 0) {
+			if (data.keep_wkb) {
+				target.Reference(source);
+				continue;
+			}
+			// Geometries of a file are only converted if the column of the scan is a geometry as well
+			auto slot = state.geometry_slots[col_idx];
+			if (slot != DConstants::INVALID_INDEX) {
+				target.Reference(source);
+				ConvertWKB(target, state.geometries.data[slot], count);
+				continue;
+			}
+		}
+		// Columns of which the type differs between files are cast to the type of the scan
+		if (reader_data.cast_map.find(reader_data.column_ids[i]) != reader_data.cast_map.end()) {
+			VectorOperations::Cast(context, source, target, count);
+		} else {
+			target.Reference(source);
+		}
+	}
+
+	MultiFileReader::FinalizeChunk(data.reader_bind, reader_data, output);
+}
+
 void GdalTableFunction::Scan(ClientContext &context, TableFunctionInput &input, DataChunk &output) {
 	if (!input.local_state) {
 		return;
@@ -560,66 +1237,134 @@ void GdalTableFunction::Scan(ClientContext &context, TableFunctionInput &input,
 
 	//! Out of tuples in this chunk
 	if (state.chunk_offset >= (idx_t)state.chunk->arrow_array.length) {
-		if (!ArrowScanParallelStateNext(context, input.bind_data.get(), state, global_state)) {
+		if (!ScanNext(context, data, state, global_state)) {
 			return;
 		}
 	}
 	auto output_size = MinValue<int64_t>(STANDARD_VECTOR_SIZE, state.chunk->arrow_array.length - state.chunk_offset);
 	data.lines_read += output_size;
 
-	if (global_state.CanRemoveFilterColumns()) {
+	// The columns that are only needed for filters are read as well, and removed afterwards
+	auto can_remove_filter_columns = global_state.CanRemoveFilterColumns();
+	auto &chunk = can_remove_filter_columns ? state.all_columns : output;
+	if (can_remove_filter_columns) {
 		state.all_columns.Reset();
-		state.all_columns.SetCardinality(output_size);
-		ArrowToDuckDB(state, data.arrow_table.GetColumns(), state.all_columns, data.lines_read - output_size, false);
-		output.ReferenceColumns(state.all_columns, global_state.projection_ids);
-	} else {
-		output.SetCardinality(output_size);
-		ArrowToDuckDB(state, data.arrow_table.GetColumns(), output, data.lines_read - output_size, false);
 	}
+	chunk.SetCardinality(output_size);
+	// The geometries of the previous chunk have been consumed, reuse their buffers
+	state.geometries.Reset();
 
-	if (!data.keep_wkb) {
-		// Find the geometry columns
-		for (idx_t col_idx = 0; col_idx < state.column_ids.size(); col_idx++) {
-			auto mapped_idx = state.column_ids[col_idx];
-			if (data.geometry_column_ids.find(mapped_idx) != data.geometry_column_ids.end()) {
-				// Found a geometry column
-				// Convert the WKB columns to a geometry column
-				state.factory.allocator.Reset();
-				auto &wkb_vec = output.data[col_idx];
-				Vector geom_vec(core::GeoTypes::GEOMETRY(), output_size);
-				UnaryExecutor::Execute<string_t, string_t>(wkb_vec, geom_vec, output_size, [&](string_t input) {
-					auto geometry = state.factory.FromWKB(input.GetDataUnsafe(), input.GetSize());
-					return state.factory.Serialize(geom_vec, geometry);
-				});
-				output.data[col_idx].ReferenceAndSetType(geom_vec);
+	if (data.multi_file) {
+		ScanFileColumns(context, data, state, chunk, data.lines_read - output_size);
+	} else {
+		{
+			ProjectedArrowChildren children(state.chunk->arrow_array, global_state.arrow_child_ids,
+			                                state.projected_children);
+			ArrowToDuckDB(state, data.arrow_table.GetColumns(), chunk, data.lines_read - output_size, true);
+		}
+
+		if (!data.keep_wkb) {
+			// Find the geometry columns
+			for (idx_t col_idx = 0; col_idx < state.column_ids.size(); col_idx++) {
+				auto mapped_idx = state.column_ids[col_idx];
+				if (data.geometry_column_ids.find(mapped_idx) != data.geometry_column_ids.end()) {
+					// Found a geometry column
+					// Convert the WKB columns to a geometry column
+					ConvertWKB(chunk.data[col_idx], state.geometries.data[state.geometry_slots[col_idx]], output_size);
+				}
 			}
 		}
 	}
 
+	if (can_remove_filter_columns) {
+		output.ReferenceColumns(state.all_columns, global_state.projection_ids);
+	}
+
 	output.Verify();
 	state.chunk_offset += output.size();
 }
 
-unique_ptr<NodeStatistics> GdalTableFunction::Cardinality(ClientContext &context, const FunctionData *data) {
-	auto &gdal_data = data->Cast<GdalScanFunctionData>();
-	auto result = make_uniq<NodeStatistics>();
+//-----------------------------------------------------------------------------
+// Filter Pushdown
+//-----------------------------------------------------------------------------
+// Turn spatial predicates on the (first) geometry column into a spatial filter on the layer, so that drivers with a
+// spatial index only read the features that can pass. The filters are kept, as OGR only checks for an intersection.
+void GdalTableFunction::PushdownComplexFilter(ClientContext &context, LogicalGet &get, FunctionData *bind_data_p,
+                                              vector<unique_ptr<Expression>> &filters) {
+	auto &data = bind_data_p->Cast<GdalScanFunctionData>();
+	if (data.multi_file) {
+		// Skip the files that can not pass the filters on the file name and hive partitions
+		MultiFileReader::ComplexFilterPushdown(context, data.files, data.file_options, get, filters);
+	}
+	if (data.geometry_column_ids.empty()) {
+		return;
+	}
+	// The layer spatial filter and extent apply to the first geometry field
+	auto column_idx = *std::min_element(data.geometry_column_ids.begin(), data.geometry_column_ids.end());
+	if (data.all_types[column_idx] != core::GeoTypes::GEOMETRY()) {
+		return;
+	}
 
-	if (gdal_data.sequential_layer_scan) {
-		// It would be too expensive to calculate the cardinality for a sequential layer scan
-		// as we would have to scan through all the layers twice.
-		return result;
+	vector<core::BoundingBox> boxes;
+	if (data.statistics.has_extent) {
+		// If the extent is up to date, no geometry can intersect a box outside of it
+		core::SpatialFilterPushdown::GetFilterBoxes(get, filters, column_idx, false, boxes);
+		for (auto &box : boxes) {
+			data.extent_disjoint = data.extent_disjoint || !box.Intersects(data.statistics.extent);
+		}
+		boxes.clear();
+	}
+
+	if (data.spatial_filter && !data.spatial_filter_pushed_down) {
+		// An explicit spatial filter takes precedence
+		return;
 	}
 
-	// Some drivers wont return a feature count if it would be to expensive to calculate
-	// (unless we pass 1 "= force" to the function calculate)
-	auto layer = open_layer(gdal_data);
+	// OGR tests the actual geometries against the filter, so only use filters that imply such an intersection
+	core::SpatialFilterPushdown::GetFilterBoxes(get, filters, column_idx, true, boxes);
 
-	auto count = layer->GetFeatureCount(0);
-	if (count > -1) {
+	// Every box has to be intersected, pick the most selective one
+	const core::BoundingBox *best = nullptr;
+	double best_area = 0;
+	for (auto &box : boxes) {
+		if (box.minx > box.maxx || box.miny > box.maxy) {
+			// Nothing can pass, leave it to the filters
+			return;
+		}
+		auto area = (box.maxx - box.minx) * (box.maxy - box.miny);
+		if (!best || area < best_area) {
+			best = &box;
+			best_area = area;
+		}
+	}
+	if (!best) {
+		return;
+	}
+	data.spatial_filter = make_uniq<RectangleSpatialFilter>(best->minx, best->miny, best->maxx, best->maxy);
+	data.spatial_filter_pushed_down = true;
+}
+
+unique_ptr<NodeStatistics> GdalTableFunction::Cardinality(ClientContext &context, const FunctionData *data) {
+	auto &gdal_data = data->Cast<GdalScanFunctionData>();
+	if (gdal_data.extent_disjoint) {
+		auto result = make_uniq<NodeStatistics>();
 		result->has_estimated_cardinality = true;
-		result->estimated_cardinality = count;
+		result->estimated_cardinality = 0;
+		return result;
 	}
 
+	// The feature count is only known if the drivers could provide it cheaply at bind time. It is not guaranteed
+	// to be exact, so it is not used as the maximum cardinality.
+	auto result = make_uniq<NodeStatistics>();
+	auto &statistics = gdal_data.statistics;
+	if (!statistics.has_feature_count || gdal_data.statistics_file_count == 0) {
+		return result;
+	}
+
+	// Files may have been skipped by filter pushdown since, assume that they are all about as large
+	result->has_estimated_cardinality = true;
+	result->estimated_cardinality =
+	    statistics.feature_count * gdal_data.files.size() / gdal_data.statistics_file_count;
 	return result;
 }
 
@@ -652,6 +1397,7 @@ void GdalTableFunction::Register(DatabaseInstance &db) {
 
 	scan.projection_pushdown = true;
 	scan.filter_pushdown = true;
+	scan.pushdown_complex_filter = GdalTableFunction::PushdownComplexFilter;
 
 	scan.named_parameters["open_options"] = LogicalType::LIST(LogicalType::VARCHAR);
 	scan.named_parameters["allowed_drivers"] = LogicalType::LIST(LogicalType::VARCHAR);
@@ -662,6 +1408,12 @@ void GdalTableFunction::Register(DatabaseInstance &db) {
 	scan.named_parameters["sequential_layer_scan"] = LogicalType::BOOLEAN;
 	scan.named_parameters["max_batch_size"] = LogicalType::INTEGER;
 	scan.named_parameters["keep_wkb"] = LogicalType::BOOLEAN;
+	// filename, hive_partitioning and union_by_name
+	MultiFileReader::AddParameters(scan);
+	set.AddFunction(scan);
+
+	// A list of files
+	scan.arguments = {LogicalType::LIST(LogicalType::VARCHAR)};
 	set.AddFunction(scan);
 
 	ExtensionUtil::RegisterFunction(db, set);
@@ -673,4 +1425,4 @@ void GdalTableFunction::Register(DatabaseInstance &db) {
 
 } // namespace gdal
 
-} // namespace spatial
\ No newline at end of file
+} // namespace spatial
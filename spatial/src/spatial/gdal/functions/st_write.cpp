@@ -1,4 +1,7 @@
 #include "duckdb/catalog/catalog.hpp"
+#include "duckdb/common/sort/sort.hpp"
+#include "duckdb/common/types/column/column_data_collection.hpp"
+#include "duckdb/common/types/column/column_data_consumer.hpp"
 #include "duckdb/common/types/value.hpp"
 #include "duckdb/function/copy_function.hpp"
 #include "duckdb/function/table_function.hpp"
@@ -7,8 +10,11 @@
 #include "duckdb/parser/parsed_data/copy_info.hpp"
 #include "duckdb/parser/parsed_data/create_copy_function_info.hpp"
 #include "duckdb/parser/parsed_data/create_table_function_info.hpp"
+#include "duckdb/execution/physical_operator.hpp"
+#include "duckdb/planner/expression/bound_reference_expression.hpp"
 #include "spatial/core/types.hpp"
 #include "spatial/core/geometry/geometry_factory.hpp"
+#include "spatial/core/geometry/space_filling_curve.hpp"
 #include "spatial/gdal/functions.hpp"
 #include "spatial/gdal/file_handler.hpp"
 
@@ -28,6 +34,9 @@ struct BindData : public TableFunctionData {
 	vector<string> dataset_creation_options;
 	vector<string> layer_creation_options;
 	string target_srs;
+	// If set, the features are buffered and written in the order of this space filling curve ("hilbert" or "zorder")
+	string spatial_sort;
+	idx_t spatial_sort_column_idx = DConstants::INVALID_INDEX;
 
 	BindData(string file_path, vector<LogicalType> field_sql_types, vector<string> field_names)
 	    : file_path(std::move(file_path)), field_sql_types(std::move(field_sql_types)),
@@ -37,6 +46,8 @@ struct BindData : public TableFunctionData {
 
 struct LocalState : public LocalFunctionData {
 	core::GeometryFactory factory;
+	// The features encoded by this thread that have not been written to the layer yet
+	vector<OGRFeatureUniquePtr> features;
 	explicit LocalState(ClientContext &context) : factory(BufferAllocator::Get(context)) {
 	}
 };
@@ -45,13 +56,34 @@ struct GlobalState : public GlobalFunctionData {
 	mutex lock;
 	GDALDatasetUniquePtr dataset;
 	OGRLayer *layer;
+	// The layer definition is only read once the layer is created, so threads can encode features concurrently
+	OGRFeatureDefn *feature_defn;
 	vector<unique_ptr<OGRFieldDefn>> field_defs;
+	// The buffered rows when sorting spatially
+	unique_ptr<ColumnDataCollection> sort_buffer;
+	// The extent of the buffered geometries, which the space filling curve spans
+	core::BoundingBox sort_extent;
+
+	// Features are written in transactions of up to TRANSACTION_SIZE features, if the layer supports it
+	bool supports_transactions;
+	bool in_transaction = false;
+	idx_t uncommitted_count = 0;
 
 	GlobalState(GDALDatasetUniquePtr dataset, OGRLayer *layer, vector<unique_ptr<OGRFieldDefn>> field_defs)
-	    : dataset(std::move(dataset)), layer(layer), field_defs(std::move(field_defs)) {
+	    : dataset(std::move(dataset)), layer(layer), feature_defn(layer->GetLayerDefn()),
+	      field_defs(std::move(field_defs)), supports_transactions(layer->TestCapability(OLCTransactions)) {
 	}
 };
 
+struct PreparedBatch : public PreparedBatchData {
+	vector<OGRFeatureUniquePtr> features;
+};
+
+// The number of features a thread encodes before handing them to the writer
+static constexpr idx_t LOCAL_FEATURE_BUFFER_SIZE = STANDARD_VECTOR_SIZE * 4;
+// The number of features written per layer transaction
+static constexpr idx_t TRANSACTION_SIZE = 100000;
+
 //===--------------------------------------------------------------------===//
 // Bind
 //===--------------------------------------------------------------------===//
@@ -107,6 +139,16 @@ static unique_ptr<FunctionData> Bind(ClientContext &context, const CopyInfo &inf
 			} else {
 				throw BinderException("SRS must be a string");
 			}
+		} else if (StringUtil::Upper(option.first) == "SPATIAL_SORT") {
+			auto set = option.second.front();
+			if (set.type().id() != LogicalTypeId::VARCHAR) {
+				throw BinderException("Spatial sort must be a string");
+			}
+			auto curve = StringUtil::Lower(set.GetValue<string>());
+			if (curve != "hilbert" && curve != "zorder") {
+				throw BinderException("Spatial sort must be either 'hilbert' or 'zorder'");
+			}
+			bind_data->spatial_sort = curve;
 		} else {
 			throw BinderException("Unknown option '%s'", option.first);
 		}
@@ -117,10 +159,16 @@ static unique_ptr<FunctionData> Bind(ClientContext &context, const CopyInfo &inf
 		throw BinderException("Driver name must be specified");
 	}
 
-	if (bind_data->layer_name.empty()) {
-		// Default to the base name of the file
-		auto &fs = FileSystem::GetFileSystem(context);
-		bind_data->layer_name = fs.ExtractBaseName(bind_data->file_path);
+	if (!bind_data->spatial_sort.empty()) {
+		for (idx_t i = 0; i < sql_types.size(); i++) {
+			if (sql_types[i] == core::GeoTypes::GEOMETRY()) {
+				bind_data->spatial_sort_column_idx = i;
+				break;
+			}
+		}
+		if (bind_data->spatial_sort_column_idx == DConstants::INVALID_INDEX) {
+			throw BinderException("Spatial sort requires a GEOMETRY column");
+		}
 	}
 
 	return std::move(bind_data);
@@ -140,6 +188,7 @@ static unique_ptr<LocalFunctionData> InitLocal(ExecutionContext &context, Functi
 //===--------------------------------------------------------------------===//
 static bool IsGeometryType(const LogicalType &type) {
 	return type == core::GeoTypes::WKB_BLOB() || type == core::GeoTypes::POINT_2D() ||
+	       type == core::GeoTypes::LINESTRING_2D() || type == core::GeoTypes::POLYGON_2D() ||
 	       type == core::GeoTypes::GEOMETRY();
 }
 
@@ -165,6 +214,11 @@ static unique_ptr<OGRFieldDefn> OGRFieldTypeFromLogicalType(const string &name,
 	case LogicalTypeId::INTEGER: {
 		return make_uniq<OGRFieldDefn>(name.c_str(), OFTInteger);
 	}
+	case LogicalTypeId::UTINYINT:
+	case LogicalTypeId::USMALLINT:
+		return make_uniq<OGRFieldDefn>(name.c_str(), OFTInteger);
+	// Wider so that all the values fit, e.g. the keys of a spatial partitioning
+	case LogicalTypeId::UINTEGER:
 	case LogicalTypeId::BIGINT:
 		return make_uniq<OGRFieldDefn>(name.c_str(), OFTInteger64);
 	case LogicalTypeId::FLOAT: {
@@ -234,13 +288,42 @@ static unique_ptr<GlobalFunctionData> InitGlobal(ClientContext &context, Functio
 		throw IOException("Could not open driver");
 	}
 
+	// With PER_THREAD_OUTPUT or PARTITION_BY we are initialized once per output file, with a generated file name.
+	// The copy function has no fixed extension, so complete the name with the extension of the driver instead.
+	auto dataset_path = file_path;
+	if (StringUtil::EndsWith(dataset_path, ".")) {
+		dataset_path.pop_back();
+		string extension;
+		auto extension_item = driver->GetMetadataItem(GDAL_DMD_EXTENSION);
+		auto extensions_item = driver->GetMetadataItem(GDAL_DMD_EXTENSIONS);
+		if (extension_item) {
+			extension = extension_item;
+		} else if (extensions_item) {
+			// Space separated, the first one is the preferred one
+			auto extensions = StringUtil::Split(extensions_item, ' ');
+			if (!extensions.empty()) {
+				extension = extensions.front();
+			}
+		}
+		if (!extension.empty()) {
+			dataset_path += "." + extension;
+		}
+	}
+
+	// Default to the base name of the file
+	auto layer_name = gdal_data.layer_name;
+	if (layer_name.empty()) {
+		auto &fs = FileSystem::GetFileSystem(context);
+		layer_name = fs.ExtractBaseName(dataset_path);
+	}
+
 	// Create the dataset
 	auto data_creation_options = vector<char const *>();
 	char **dco = nullptr;
 	for (auto &option : gdal_data.dataset_creation_options) {
 		dco = CSLAddString(dco, option.c_str());
 	}
-	auto dataset = GDALDatasetUniquePtr(driver->Create(file_path.c_str(), 0, 0, 0, GDT_Unknown, dco));
+	auto dataset = GDALDatasetUniquePtr(driver->Create(dataset_path.c_str(), 0, 0, 0, GDT_Unknown, dco));
 	if (!dataset) {
 		throw IOException("Could not open dataset");
 	}
@@ -260,7 +343,7 @@ static unique_ptr<GlobalFunctionData> InitGlobal(ClientContext &context, Functio
 	// so we have to pass nullptr if we want the default behavior.
 	OGRSpatialReference *srs_ptr = gdal_data.target_srs.empty() ? nullptr : &srs;
 
-	auto layer = dataset->CreateLayer(gdal_data.layer_name.c_str(), srs_ptr, wkbUnknown, lco);
+	auto layer = dataset->CreateLayer(layer_name.c_str(), srs_ptr, wkbUnknown, lco);
 	if (!layer) {
 		throw IOException("Could not create layer");
 	}
@@ -288,6 +371,9 @@ static unique_ptr<GlobalFunctionData> InitGlobal(ClientContext &context, Functio
 		}
 	}
 	auto global_data = make_uniq<GlobalState>(std::move(dataset), layer, std::move(field_defs));
+	if (!gdal_data.spatial_sort.empty()) {
+		global_data->sort_buffer = make_uniq<ColumnDataCollection>(context, gdal_data.field_sql_types);
+	}
 
 	return std::move(global_data);
 }
@@ -296,10 +382,76 @@ static unique_ptr<GlobalFunctionData> InitGlobal(ClientContext &context, Functio
 // Sink
 //===--------------------------------------------------------------------===//
 
-static OGRGeometryUniquePtr OGRGeometryFromValue(const LogicalType &type, const Value &value,
-                                                 core::GeometryFactory &factory) {
+// Build the OGR geometry straight from the deserialized geometry, whose vertices still point into the blob.
+// OGRRawPoint has the same layout as our vertices, and setPoints copies them with memcpy, so alignment does not matter.
+static void SetOGRPoints(OGRSimpleCurve &curve, const core::VertexVector &vertices) {
+	curve.setPoints(static_cast<int>(vertices.Count()), reinterpret_cast<const OGRRawPoint *>(vertices.data));
+}
+
+static OGRPolygon *OGRPolygonFromPolygon(const core::Polygon &polygon) {
+	auto ogr_polygon = new OGRPolygon();
+	for (auto &ring : polygon.Rings()) {
+		auto ogr_ring = new OGRLinearRing();
+		SetOGRPoints(*ogr_ring, ring);
+		ogr_polygon->addRingDirectly(ogr_ring);
+	}
+	return ogr_polygon;
+}
+
+static OGRGeometry *OGRGeometryFromGeometry(const core::Geometry &geom) {
+	switch (geom.Type()) {
+	case core::GeometryType::POINT: {
+		auto &point = geom.GetPoint();
+		if (point.IsEmpty()) {
+			return new OGRPoint();
+		}
+		auto vertex = point.GetVertex();
+		return new OGRPoint(vertex.x, vertex.y);
+	}
+	case core::GeometryType::LINESTRING: {
+		auto ogr_line = new OGRLineString();
+		SetOGRPoints(*ogr_line, geom.GetLineString().Vertices());
+		return ogr_line;
+	}
+	case core::GeometryType::POLYGON:
+		return OGRPolygonFromPolygon(geom.GetPolygon());
+	case core::GeometryType::MULTIPOINT: {
+		auto ogr_multi = new OGRMultiPoint();
+		for (auto &point : geom.GetMultiPoint()) {
+			ogr_multi->addGeometryDirectly(OGRGeometryFromGeometry(point));
+		}
+		return ogr_multi;
+	}
+	case core::GeometryType::MULTILINESTRING: {
+		auto ogr_multi = new OGRMultiLineString();
+		for (auto &line : geom.GetMultiLineString()) {
+			ogr_multi->addGeometryDirectly(OGRGeometryFromGeometry(line));
+		}
+		return ogr_multi;
+	}
+	case core::GeometryType::MULTIPOLYGON: {
+		auto ogr_multi = new OGRMultiPolygon();
+		for (auto &polygon : geom.GetMultiPolygon()) {
+			ogr_multi->addGeometryDirectly(OGRPolygonFromPolygon(polygon));
+		}
+		return ogr_multi;
+	}
+	case core::GeometryType::GEOMETRYCOLLECTION: {
+		auto ogr_collection = new OGRGeometryCollection();
+		for (auto &child : geom.GetGeometryCollection()) {
+			ogr_collection->addGeometryDirectly(OGRGeometryFromGeometry(child));
+		}
+		return ogr_collection;
+	}
+	default:
+		throw NotImplementedException("Unsupported geometry type");
+	}
+}
+
+static OGRGeometryUniquePtr OGRGeometryFromVector(const LogicalType &type, Vector &vector, idx_t row_idx,
+                                                  core::GeometryFactory &factory) {
 	if (type == core::GeoTypes::WKB_BLOB()) {
-		auto str = value.GetValueUnsafe<string_t>();
+		auto str = FlatVector::GetData<string_t>(vector)[row_idx];
 
 		OGRGeometry *ptr;
 		size_t consumed;
@@ -311,60 +463,87 @@ static OGRGeometryUniquePtr OGRGeometryFromValue(const LogicalType &type, const
 		}
 		return OGRGeometryUniquePtr(ptr);
 	} else if (type == core::GeoTypes::GEOMETRY()) {
-		auto blob = value.GetValueUnsafe<string_t>();
+		auto blob = FlatVector::GetData<string_t>(vector)[row_idx];
 		auto geom = factory.Deserialize(blob);
-
-		uint32_t size;
-		auto wkb = factory.ToWKB(geom, &size);
-
-		OGRGeometry *ptr;
-		auto ok = OGRGeometryFactory::createFromWkb(wkb, nullptr, &ptr, size, wkbVariantIso);
-		if (ok != OGRERR_NONE) {
-			throw IOException("Could not parse WKB");
-		}
-		return OGRGeometryUniquePtr(ptr);
+		return OGRGeometryUniquePtr(OGRGeometryFromGeometry(geom));
 	} else if (type == core::GeoTypes::POINT_2D()) {
-		auto children = StructValue::GetChildren(value);
-		auto x = children[0].GetValue<double>();
-		auto y = children[1].GetValue<double>();
+		auto &children = StructVector::GetEntries(vector);
+		auto x = FlatVector::GetData<double>(*children[0])[row_idx];
+		auto y = FlatVector::GetData<double>(*children[1])[row_idx];
 		auto ogr_point = new OGRPoint(x, y);
 		return OGRGeometryUniquePtr(ogr_point);
+	} else if (type == core::GeoTypes::LINESTRING_2D()) {
+		auto line = FlatVector::GetData<list_entry_t>(vector)[row_idx];
+		auto &coord_vec = ListVector::GetEntry(vector);
+		auto &coord_vec_children = StructVector::GetEntries(coord_vec);
+		auto x_data = FlatVector::GetData<double>(*coord_vec_children[0]);
+		auto y_data = FlatVector::GetData<double>(*coord_vec_children[1]);
+
+		auto ogr_line = new OGRLineString();
+		ogr_line->setPoints(static_cast<int>(line.length), x_data + line.offset, y_data + line.offset);
+		return OGRGeometryUniquePtr(ogr_line);
+	} else if (type == core::GeoTypes::POLYGON_2D()) {
+		auto poly = FlatVector::GetData<list_entry_t>(vector)[row_idx];
+		auto &ring_vec = ListVector::GetEntry(vector);
+		auto ring_entries = ListVector::GetData(ring_vec);
+		auto &coord_vec = ListVector::GetEntry(ring_vec);
+		auto &coord_vec_children = StructVector::GetEntries(coord_vec);
+		auto x_data = FlatVector::GetData<double>(*coord_vec_children[0]);
+		auto y_data = FlatVector::GetData<double>(*coord_vec_children[1]);
+
+		auto ogr_polygon = new OGRPolygon();
+		for (idx_t i = 0; i < poly.length; i++) {
+			auto ring = ring_entries[poly.offset + i];
+			auto ogr_ring = new OGRLinearRing();
+			ogr_ring->setPoints(static_cast<int>(ring.length), x_data + ring.offset, y_data + ring.offset);
+			ogr_polygon->addRingDirectly(ogr_ring);
+		}
+		return OGRGeometryUniquePtr(ogr_polygon);
 	} else {
 		throw NotImplementedException("Unsupported geometry type");
 	}
 }
 
-static void SetOgrFieldFromValue(OGRFeature *feature, int field_idx, const LogicalType &type, const Value &value) {
-	// TODO: Set field by index always instead of by name for performance.
-	if (value.IsNull()) {
+static void SetOgrFieldFromVector(OGRFeature *feature, int field_idx, const LogicalType &type, Vector &vector,
+                                  idx_t row_idx) {
+	if (FlatVector::IsNull(vector, row_idx)) {
 		feature->SetFieldNull(field_idx);
 		return;
 	}
 	switch (type.id()) {
 	case LogicalTypeId::BOOLEAN:
-		feature->SetField(field_idx, value.GetValue<bool>());
+		feature->SetField(field_idx, FlatVector::GetData<bool>(vector)[row_idx]);
 		break;
 	case LogicalTypeId::TINYINT:
-		feature->SetField(field_idx, value.GetValue<int8_t>());
+		feature->SetField(field_idx, FlatVector::GetData<int8_t>(vector)[row_idx]);
 		break;
 	case LogicalTypeId::SMALLINT:
-		feature->SetField(field_idx, value.GetValue<int16_t>());
+		feature->SetField(field_idx, FlatVector::GetData<int16_t>(vector)[row_idx]);
 		break;
 	case LogicalTypeId::INTEGER:
-		feature->SetField(field_idx, value.GetValue<int32_t>());
+		feature->SetField(field_idx, FlatVector::GetData<int32_t>(vector)[row_idx]);
 		break;
 	case LogicalTypeId::BIGINT:
-		feature->SetField(field_idx, (GIntBig)value.GetValue<int64_t>());
+		feature->SetField(field_idx, (GIntBig)FlatVector::GetData<int64_t>(vector)[row_idx]);
+		break;
+	case LogicalTypeId::UTINYINT:
+		feature->SetField(field_idx, FlatVector::GetData<uint8_t>(vector)[row_idx]);
+		break;
+	case LogicalTypeId::USMALLINT:
+		feature->SetField(field_idx, FlatVector::GetData<uint16_t>(vector)[row_idx]);
+		break;
+	case LogicalTypeId::UINTEGER:
+		feature->SetField(field_idx, (GIntBig)FlatVector::GetData<uint32_t>(vector)[row_idx]);
 		break;
 	case LogicalTypeId::FLOAT:
-		feature->SetField(field_idx, value.GetValue<float>());
+		feature->SetField(field_idx, FlatVector::GetData<float>(vector)[row_idx]);
 		break;
 	case LogicalTypeId::DOUBLE:
-		feature->SetField(field_idx, value.GetValue<double>());
+		feature->SetField(field_idx, FlatVector::GetData<double>(vector)[row_idx]);
 		break;
 	case LogicalTypeId::VARCHAR:
 	case LogicalTypeId::BLOB: {
-		auto str = value.GetValueUnsafe<string_t>();
+		auto str = FlatVector::GetData<string_t>(vector)[row_idx];
 		feature->SetField(field_idx, (int)str.GetSize(), str.GetDataUnsafe());
 	} break;
 	default:
@@ -374,43 +553,290 @@ static void SetOgrFieldFromValue(OGRFeature *feature, int field_idx, const Logic
 	}
 }
 
+// Encode a row of a flattened chunk as a feature. This only reads the layer definition, so it does not need the lock.
+static OGRFeatureUniquePtr CreateFeature(const BindData &bind_data, OGRFeatureDefn *feature_defn, DataChunk &input,
+                                         idx_t row_idx, core::GeometryFactory &factory) {
+	auto feature = OGRFeatureUniquePtr(OGRFeature::CreateFeature(feature_defn));
+
+	// Geometry fields do not count towards the field index, so we need to keep track of them separately.
+	idx_t field_idx = 0;
+	for (idx_t col_idx = 0; col_idx < input.ColumnCount(); col_idx++) {
+		auto &type = bind_data.field_sql_types[col_idx];
+		auto &vector = input.data[col_idx];
+
+		if (IsGeometryType(type)) {
+			if (FlatVector::IsNull(vector, row_idx)) {
+				continue;
+			}
+			// TODO: check how many geometry fields there are and use the correct one.
+			auto geom = OGRGeometryFromVector(type, vector, row_idx, factory);
+			if (feature->SetGeometryDirectly(geom.release()) != OGRERR_NONE) {
+				throw IOException("Could not set geometry");
+			}
+		} else {
+			SetOgrFieldFromVector(feature.get(), (int)field_idx, type, vector, row_idx);
+			field_idx++;
+		}
+	}
+	return feature;
+}
+
+static void CreateFeatures(const BindData &bind_data, OGRFeatureDefn *feature_defn, DataChunk &input,
+                           core::GeometryFactory &factory, vector<OGRFeatureUniquePtr> &features) {
+	factory.allocator.Reset();
+	input.Flatten();
+	for (idx_t row_idx = 0; row_idx < input.size(); row_idx++) {
+		features.push_back(CreateFeature(bind_data, feature_defn, input, row_idx, factory));
+	}
+}
+
+static void CommitTransaction(GlobalState &global_state) {
+	if (!global_state.in_transaction) {
+		return;
+	}
+	global_state.in_transaction = false;
+	global_state.uncommitted_count = 0;
+	if (global_state.layer->CommitTransaction() != OGRERR_NONE) {
+		throw IOException("Could not commit transaction");
+	}
+}
+
+// Write the features to the layer, batching them into large transactions. Takes the global lock.
+static void WriteFeatures(GlobalState &global_state, vector<OGRFeatureUniquePtr> &features) {
+	lock_guard<mutex> d_lock(global_state.lock);
+	auto layer = global_state.layer;
+	for (auto &feature : features) {
+		if (global_state.supports_transactions && !global_state.in_transaction) {
+			if (layer->StartTransaction() != OGRERR_NONE) {
+				throw IOException("Could not start transaction");
+			}
+			global_state.in_transaction = true;
+		}
+		if (layer->CreateFeature(feature.get()) != OGRERR_NONE) {
+			throw IOException("Could not create feature");
+		}
+		if (global_state.in_transaction && ++global_state.uncommitted_count >= TRANSACTION_SIZE) {
+			CommitTransaction(global_state);
+		}
+	}
+	features.clear();
+}
+
+// Grow the extent by the bounding boxes of the (non-null, non-empty) geometries in the chunk
+static void UpdateSortExtent(DataChunk &chunk, idx_t geom_idx, core::BoundingBox &extent) {
+	UnifiedVectorFormat format;
+	chunk.data[geom_idx].ToUnifiedFormat(chunk.size(), format);
+	auto geoms = UnifiedVectorFormat::GetData<string_t>(format);
+	for (idx_t i = 0; i < chunk.size(); i++) {
+		auto idx = format.sel->get_index(i);
+		core::BoundingBox bbox;
+		if (!format.validity.RowIsValid(idx) ||
+		    !core::GeometryFactory::TryGetSerializedBoundingBox(geoms[idx], bbox)) {
+			continue;
+		}
+		extent.minx = MinValue(extent.minx, bbox.minx);
+		extent.miny = MinValue(extent.miny, bbox.miny);
+		extent.maxx = MaxValue(extent.maxx, bbox.maxx);
+		extent.maxy = MaxValue(extent.maxy, bbox.maxy);
+	}
+}
+
+static void MergeSortExtent(GlobalState &global_state, const core::BoundingBox &extent) {
+	auto &sort_extent = global_state.sort_extent;
+	sort_extent.minx = MinValue(sort_extent.minx, extent.minx);
+	sort_extent.miny = MinValue(sort_extent.miny, extent.miny);
+	sort_extent.maxx = MaxValue(sort_extent.maxx, extent.maxx);
+	sort_extent.maxy = MaxValue(sort_extent.maxy, extent.maxy);
+}
+
 static void Sink(ExecutionContext &context, FunctionData &bdata, GlobalFunctionData &gstate, LocalFunctionData &lstate,
                  DataChunk &input) {
 	auto &bind_data = (BindData &)bdata;
 	auto &global_state = (GlobalState &)gstate;
 	auto &local_state = (LocalState &)lstate;
-	local_state.factory.allocator.Reset();
 
-	lock_guard<mutex> d_lock(global_state.lock);
-	auto layer = global_state.layer;
+	if (global_state.sort_buffer) {
+		// We can only write the features once we know the extent of all of them
+		core::BoundingBox extent;
+		UpdateSortExtent(input, bind_data.spatial_sort_column_idx, extent);
+		lock_guard<mutex> d_lock(global_state.lock);
+		MergeSortExtent(global_state, extent);
+		global_state.sort_buffer->Append(input);
+		return;
+	}
 
-	// Create the feature
-	input.Flatten();
-	for (idx_t row_idx = 0; row_idx < input.size(); row_idx++) {
+	// Encode the features outside of the lock, and only take it to write them in bulk
+	CreateFeatures(bind_data, global_state.feature_defn, input, local_state.factory, local_state.features);
+	if (local_state.features.size() >= LOCAL_FEATURE_BUFFER_SIZE) {
+		WriteFeatures(global_state, local_state.features);
+	}
+}
 
-		auto feature = OGRFeatureUniquePtr(OGRFeature::CreateFeature(layer->GetLayerDefn()));
+//===--------------------------------------------------------------------===//
+// Combine
+//===--------------------------------------------------------------------===//
+static void Combine(ExecutionContext &context, FunctionData &bind_data, GlobalFunctionData &gstate,
+                    LocalFunctionData &lstate) {
+	auto &global_state = (GlobalState &)gstate;
+	auto &local_state = (LocalState &)lstate;
+	if (!local_state.features.empty()) {
+		WriteFeatures(global_state, local_state.features);
+	}
+}
 
-		// Geometry fields do not count towards the field index, so we need to keep track of them separately.
-		idx_t field_idx = 0;
-		for (idx_t col_idx = 0; col_idx < input.ColumnCount(); col_idx++) {
-			auto &type = bind_data.field_sql_types[col_idx];
-			auto value = input.GetValue(col_idx, row_idx);
+//===--------------------------------------------------------------------===//
+// Batches
+//===--------------------------------------------------------------------===//
+// When the insertion order is preserved, batches are encoded in parallel and then flushed in order.
+static unique_ptr<PreparedBatchData> PrepareBatch(ClientContext &context, FunctionData &bdata,
+                                                  GlobalFunctionData &gstate,
+                                                  unique_ptr<ColumnDataCollection> collection) {
+	auto &bind_data = (BindData &)bdata;
+	auto &global_state = (GlobalState &)gstate;
+	auto batch = make_uniq<PreparedBatch>();
 
-			if (IsGeometryType(type)) {
-				// TODO: check how many geometry fields there are and use the correct one.
-				auto geom = OGRGeometryFromValue(type, value, local_state.factory);
-				if (feature->SetGeometry(geom.get()) != OGRERR_NONE) {
-					throw IOException("Could not set geometry");
-				}
-			} else {
-				SetOgrFieldFromValue(feature.get(), (int)field_idx, type, value);
-				field_idx++;
+	if (global_state.sort_buffer) {
+		// The order is decided by the spatial sort instead
+		core::BoundingBox extent;
+		for (auto &chunk : collection->Chunks()) {
+			UpdateSortExtent(chunk, bind_data.spatial_sort_column_idx, extent);
+		}
+		lock_guard<mutex> d_lock(global_state.lock);
+		MergeSortExtent(global_state, extent);
+		global_state.sort_buffer->Combine(*collection);
+		return std::move(batch);
+	}
+
+	core::GeometryFactory factory(BufferAllocator::Get(context));
+	batch->features.reserve(collection->Count());
+	for (auto &chunk : collection->Chunks()) {
+		CreateFeatures(bind_data, global_state.feature_defn, chunk, factory, batch->features);
+	}
+	return std::move(batch);
+}
+
+static void FlushBatch(ClientContext &context, FunctionData &bind_data, GlobalFunctionData &gstate,
+                       PreparedBatchData &batch) {
+	GdalFileHandler::SetLocalClientContext(context);
+	auto &global_state = (GlobalState &)gstate;
+	auto &prepared_batch = (PreparedBatch &)batch;
+	WriteFeatures(global_state, prepared_batch.features);
+}
+
+static CopyFunctionExecutionMode ExecutionMode(bool preserve_insertion_order, bool supports_batch_index) {
+	if (!preserve_insertion_order) {
+		return CopyFunctionExecutionMode::PARALLEL_COPY_TO_FILE;
+	}
+	if (supports_batch_index) {
+		return CopyFunctionExecutionMode::BATCH_COPY_TO_FILE;
+	}
+	return CopyFunctionExecutionMode::REGULAR_COPY_TO_FILE;
+}
+
+//===--------------------------------------------------------------------===//
+// Spatial Sort
+//===--------------------------------------------------------------------===//
+// The rows are sorted with the sort of DuckDB on their position on the curve, so the sort can spill to disk.
+// The buffered chunks are released as soon as they have been sunk into the sort.
+static void WriteSpatiallySorted(ClientContext &context, const BindData &bind_data, GlobalState &global_state) {
+	auto &buffer = *global_state.sort_buffer;
+	if (buffer.Count() == 0) {
+		return;
+	}
+	auto &buffer_manager = BufferManager::GetBufferManager(context);
+	auto geom_idx = bind_data.spatial_sort_column_idx;
+	auto &extent = global_state.sort_extent;
+	auto use_hilbert = bind_data.spatial_sort == "hilbert";
+
+	// Sort on the key, and on the position in the buffer to keep the sort stable.
+	// Null and empty geometries have no key and are written last.
+	vector<BoundOrderByNode> orders;
+	orders.emplace_back(OrderType::ASCENDING, OrderByNullType::NULLS_LAST,
+	                    make_uniq<BoundReferenceExpression>(LogicalType::UINTEGER, 0));
+	orders.emplace_back(OrderType::ASCENDING, OrderByNullType::NULLS_LAST,
+	                    make_uniq<BoundReferenceExpression>(LogicalType::UBIGINT, 1));
+	RowLayout payload_layout;
+	payload_layout.Initialize(buffer.Types());
+	GlobalSortState global_sort_state(buffer_manager, orders, payload_layout);
+	global_sort_state.external = ClientConfig::GetConfig(context).force_external;
+	LocalSortState local_sort_state;
+	local_sort_state.Initialize(global_sort_state, buffer_manager);
+	auto memory_limit = PhysicalOperator::GetMaxThreadMemory(context);
+
+	vector<column_t> column_ids;
+	for (idx_t col_idx = 0; col_idx < buffer.ColumnCount(); col_idx++) {
+		column_ids.push_back(col_idx);
+	}
+	ColumnDataConsumer consumer(buffer, std::move(column_ids));
+	consumer.InitializeScan();
+	ColumnDataConsumerScanState scan_state;
+
+	DataChunk chunk;
+	buffer.InitializeScanChunk(chunk);
+	DataChunk keys;
+	keys.Initialize(Allocator::Get(context), {LogicalType::UINTEGER, LogicalType::UBIGINT});
+	idx_t row_number = 0;
+	while (consumer.AssignChunk(scan_state)) {
+		chunk.Reset();
+		consumer.ScanChunk(scan_state, chunk);
+
+		keys.Reset();
+		auto &key_vec = keys.data[0];
+		auto key_data = FlatVector::GetData<uint32_t>(key_vec);
+		auto row_numbers = FlatVector::GetData<uint64_t>(keys.data[1]);
+		auto &geom_vec = chunk.data[geom_idx];
+		auto geoms = FlatVector::GetData<string_t>(geom_vec);
+		for (idx_t row_idx = 0; row_idx < chunk.size(); row_idx++) {
+			row_numbers[row_idx] = row_number++;
+			core::BoundingBox bbox;
+			if (FlatVector::IsNull(geom_vec, row_idx) ||
+			    !core::GeometryFactory::TryGetSerializedBoundingBox(geoms[row_idx], bbox)) {
+				FlatVector::SetNull(key_vec, row_idx, true);
+				continue;
 			}
+			auto x = bbox.minx + (bbox.maxx - bbox.minx) * 0.5;
+			auto y = bbox.miny + (bbox.maxy - bbox.miny) * 0.5;
+			key_data[row_idx] = use_hilbert ? core::SpaceFillingCurve::Hilbert(x, y, extent)
+			                                : core::SpaceFillingCurve::ZOrder(x, y, extent);
 		}
-		if (layer->CreateFeature(feature.get()) != OGRERR_NONE) {
-			throw IOException("Could not create feature");
+		keys.SetCardinality(chunk.size());
+
+		local_sort_state.SinkChunk(keys, chunk);
+		consumer.FinishChunk(scan_state);
+		if (local_sort_state.SizeInBytes() >= memory_limit) {
+			local_sort_state.Sort(global_sort_state, true);
+		}
+	}
+	global_sort_state.AddLocalState(local_sort_state);
+	global_sort_state.PrepareMergePhase();
+	while (global_sort_state.sorted_blocks.size() > 1) {
+		global_sort_state.InitializeMergeRound();
+		MergeSorter merge_sorter(global_sort_state, buffer_manager);
+		merge_sorter.PerformInMergeRound();
+		global_sort_state.CompleteMergeRound();
+	}
+
+	core::GeometryFactory factory(BufferAllocator::Get(context));
+	vector<OGRFeatureUniquePtr> features;
+	PayloadScanner scanner(global_sort_state);
+	DataChunk sorted;
+	sorted.Initialize(Allocator::Get(context), buffer.Types());
+	while (true) {
+		sorted.Reset();
+		scanner.Scan(sorted);
+		if (sorted.size() == 0) {
+			break;
+		}
+		factory.allocator.Reset();
+		for (idx_t row_idx = 0; row_idx < sorted.size(); row_idx++) {
+			features.push_back(CreateFeature(bind_data, global_state.feature_defn, sorted, row_idx, factory));
+		}
+		if (features.size() >= LOCAL_FEATURE_BUFFER_SIZE) {
+			WriteFeatures(global_state, features);
 		}
 	}
+	WriteFeatures(global_state, features);
+	buffer.Reset();
 }
 
 //===--------------------------------------------------------------------===//
@@ -419,6 +845,10 @@ static void Sink(ExecutionContext &context, FunctionData &bdata, GlobalFunctionD
 static void Finalize(ClientContext &context, FunctionData &bind_data, GlobalFunctionData &gstate) {
 	GdalFileHandler::SetLocalClientContext(context);
 	auto &global_state = (GlobalState &)gstate;
+	if (global_state.sort_buffer) {
+		WriteSpatiallySorted(context, (BindData &)bind_data, global_state);
+	}
+	CommitTransaction(global_state);
 	global_state.dataset->FlushCache();
 }
 
@@ -429,7 +859,11 @@ void GdalCopyFunction::Register(DatabaseInstance &db) {
 	info.copy_to_initialize_local = InitLocal;
 	info.copy_to_initialize_global = InitGlobal;
 	info.copy_to_sink = Sink;
+	info.copy_to_combine = Combine;
 	info.copy_to_finalize = Finalize;
+	info.execution_mode = ExecutionMode;
+	info.prepare_batch = PrepareBatch;
+	info.flush_batch = FlushBatch;
 
 	ExtensionUtil::RegisterFunction(db, info);
 }
@@ -53,10 +53,13 @@ void GdalModule::Register(DatabaseInstance &db) {
 		GdalFileHandler::Register();
 	});
 
+	GdalFileHandler::RegisterSettings(db);
+
 	// Register functions
 	GdalTableFunction::Register(db);
 	GdalDriversTableFunction::Register(db);
 	GdalCopyFunction::Register(db);
+	GdalIOStatsTableFunction::Register(db);
 }
 
 } // namespace gdal
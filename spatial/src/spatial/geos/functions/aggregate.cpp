@@ -11,78 +11,203 @@ namespace spatial {
 
 namespace geos {
 
-struct GEOSAggState {
-	GEOSGeometry *geom = nullptr;
-	GEOSContextHandle_t context = nullptr;
-
-	~GEOSAggState() {
-		if (geom) {
-			GEOSGeom_destroy_r(context, geom);
-			geom = nullptr;
-		}
-		if (context) {
-			GEOS_finish_r(context);
-			context = nullptr;
-		}
-	}
-};
-
 //------------------------------------------------------------------------
 // INTERSECTION
 //------------------------------------------------------------------------
+// The running result only ever shrinks, so we track its bounding box to skip inputs that can't change it, and stop
+// doing any work at all once it is empty. Partial results from other threads are not intersected as they are
+// combined, but collected and reduced in a balanced tree when the state is finalized.
+
+struct GEOSIntersectionAggState {
+	GEOSContextHandle_t context;
+	// The running result of the inputs seen by this state
+	GEOSGeometry *geom;
+	// Results of combined states
+	vector<GEOSGeometry *> *partials;
+	// The (exact) bounding box of the running result
+	core::BoundingBox bbox;
+	// The running result is empty, so the final result will be empty as well
+	bool is_empty;
+};
+
 struct IntersectionAggFunction {
 	template <class STATE>
 	static void Initialize(STATE &state) {
+		state.context = nullptr;
 		state.geom = nullptr;
-		state.context = GEOS_init_r();
+		state.partials = nullptr;
+		state.bbox = core::BoundingBox();
+		state.is_empty = false;
+	}
+
+	template <class STATE>
+	static void SetResult(STATE &state, GEOSGeometry *geom) {
+		if (state.geom) {
+			GEOSGeom_destroy_r(state.context, state.geom);
+		}
+		state.geom = geom;
+		if (GEOSisEmpty_r(state.context, geom)) {
+			state.is_empty = true;
+			return;
+		}
+		GEOSGeom_getExtent_r(state.context, geom, &state.bbox.minx, &state.bbox.miny, &state.bbox.maxx,
+		                     &state.bbox.maxy);
+	}
+
+	template <class STATE>
+	static void ClearPartials(STATE &state) {
+		if (state.partials) {
+			for (auto &partial : *state.partials) {
+				if (partial) {
+					GEOSGeom_destroy_r(state.context, partial);
+				}
+			}
+			state.partials->clear();
+		}
+	}
+
+	static GEOSGeometry *Intersect(GEOSContextHandle_t context, const GEOSGeometry *left, const GEOSGeometry *right) {
+		auto result = GEOSIntersection_r(context, left, right);
+		if (!result) {
+			throw InvalidInputException("Could not intersect geometries");
+		}
+		return result;
 	}
 
 	template <class STATE, class OP>
 	static void Combine(const STATE &source, STATE &target, AggregateInputData &data) {
-		if (!source.geom) {
+		if (!source.geom || target.is_empty) {
 			return;
 		}
+		if (!target.context) {
+			target.context = GEOS_init_r();
+		}
 		if (!target.geom) {
-			target.geom = GEOSGeom_clone_r(target.context, source.geom);
+			SetResult(target, GEOSGeom_clone_r(target.context, source.geom));
+		} else if (source.is_empty || !target.bbox.Intersects(source.bbox)) {
+			// The final result is going to be empty, compute it right away
+			SetResult(target, Intersect(target.context, target.geom, source.geom));
+			D_ASSERT(target.is_empty);
+		} else {
+			if (!target.partials) {
+				target.partials = new vector<GEOSGeometry *>();
+			}
+			target.partials->push_back(GEOSGeom_clone_r(target.context, source.geom));
+		}
+
+		if (target.is_empty) {
+			ClearPartials(target);
 			return;
 		}
-		auto curr = target.geom;
-		target.geom = GEOSIntersection_r(target.context, curr, source.geom);
-		GEOSGeom_destroy_r(target.context, curr);
+		if (source.partials) {
+			if (!target.partials) {
+				target.partials = new vector<GEOSGeometry *>();
+			}
+			for (auto &partial : *source.partials) {
+				target.partials->push_back(GEOSGeom_clone_r(target.context, partial));
+			}
+		}
 	}
 
 	template <class INPUT_TYPE, class STATE, class OP>
 	static void Operation(STATE &state, const INPUT_TYPE &input, AggregateUnaryInput &) {
+		if (state.is_empty) {
+			// Intersecting with an empty geometry is always empty
+			return;
+		}
+		if (!state.context) {
+			state.context = GEOS_init_r();
+		}
 		if (!state.geom) {
-			state.geom = DeserializeGEOSGeometry(input, state.context);
-		} else {
-			auto next = DeserializeGEOSGeometry(input, state.context);
-			auto curr = state.geom;
-			state.geom = GEOSIntersection_r(state.context, curr, next);
-			GEOSGeom_destroy_r(state.context, next);
-			GEOSGeom_destroy_r(state.context, curr);
+			SetResult(state, DeserializeGEOSGeometry(input, state.context));
+			return;
+		}
+
+		// If the input is a rectangle covering the running result, the result won't change
+		core::BoundingBox input_bbox;
+		if (core::GeometryFactory::TryGetSerializedRectangle(input, input_bbox) && input_bbox.Contains(state.bbox)) {
+			return;
+		}
+
+		auto next = DeserializeGEOSGeometry(input, state.context);
+		auto result = GEOSIntersection_r(state.context, state.geom, next);
+		GEOSGeom_destroy_r(state.context, next);
+		if (!result) {
+			throw InvalidInputException("Could not intersect geometries");
 		}
+		SetResult(state, result);
 	}
 
 	template <class INPUT_TYPE, class STATE, class OP>
-	static void ConstantOperation(STATE &state, const INPUT_TYPE &input, AggregateUnaryInput &, idx_t count) {
-		// There is no point in doing anything else, intersection is idempotent
-		if (!state.geom) {
-			state.geom = DeserializeGEOSGeometry(input, state.context);
+	static void ConstantOperation(STATE &state, const INPUT_TYPE &input, AggregateUnaryInput &aggr_input,
+	                              idx_t count) {
+		// Intersection is idempotent, so we only need to process the geometry once
+		Operation<INPUT_TYPE, STATE, OP>(state, input, aggr_input);
+	}
+
+	// Intersect the running result with all partial results, pairwise in a balanced tree
+	template <class STATE>
+	static void Reduce(STATE &state) {
+		if (!state.partials || state.partials->empty()) {
+			return;
+		}
+		auto &level = *state.partials;
+		level.push_back(state.geom);
+		state.geom = nullptr;
+
+		GEOSGeometry *empty_result = nullptr;
+		while (level.size() > 1 && !empty_result) {
+			idx_t next_size = 0;
+			idx_t i = 0;
+			for (; i + 1 < level.size(); i += 2) {
+				auto result = Intersect(state.context, level[i], level[i + 1]);
+				GEOSGeom_destroy_r(state.context, level[i]);
+				GEOSGeom_destroy_r(state.context, level[i + 1]);
+				level[i] = nullptr;
+				level[i + 1] = nullptr;
+				level[next_size++] = result;
+				if (GEOSisEmpty_r(state.context, result)) {
+					// No need to continue, the final result is empty
+					empty_result = result;
+					break;
+				}
+			}
+			if (empty_result) {
+				break;
+			}
+			if (i < level.size()) {
+				level[next_size++] = level[i];
+			}
+			level.resize(next_size);
+		}
+
+		auto result = empty_result ? empty_result : level[0];
+		for (auto &geom : level) {
+			if (geom == result) {
+				geom = nullptr;
+			}
 		}
+		ClearPartials(state);
+		SetResult(state, result);
 	}
 
 	template <class T, class STATE>
 	static void Finalize(STATE &state, T &target, AggregateFinalizeData &finalize_data) {
 		if (!state.geom) {
 			finalize_data.ReturnNull();
-		} else {
-			target = SerializeGEOSGeometry(finalize_data.result, state.geom, state.context);
+			return;
 		}
+		Reduce(state);
+		target = SerializeGEOSGeometry(finalize_data.result, state.geom, state.context);
 	}
 
 	template <class STATE>
 	static void Destroy(STATE &state, AggregateInputData &) {
+		if (state.partials) {
+			ClearPartials(state);
+			delete state.partials;
+			state.partials = nullptr;
+		}
 		if (state.geom) {
 			GEOSGeom_destroy_r(state.context, state.geom);
 			state.geom = nullptr;
@@ -101,63 +226,137 @@ struct IntersectionAggFunction {
 //------------------------------------------------------------------------
 // UNION
 //------------------------------------------------------------------------
+// Unioning each input into a running result one at a time is quadratic for dissolves over many adjacent polygons.
+// Instead we buffer the (serialized) inputs and union them all at once with a cascaded union, which GEOS performs
+// over an STR-tree of the inputs. To bound the memory usage, the buffer is collapsed into a partial result whenever
+// it grows past UNION_BUFFER_SIZE bytes.
+
+static constexpr idx_t UNION_BUFFER_SIZE = 16 * 1024 * 1024;
+
+struct GEOSUnionAggState {
+	// Created lazily, as most states never have to union anything before they are finalized
+	GEOSContextHandle_t context;
+	// Partial union results
+	vector<GEOSGeometry *> *geoms;
+	// Serialized input geometries that have not been unioned yet
+	vector<string> *blobs;
+	idx_t blobs_size;
+};
 
 struct UnionAggFunction {
 	template <class STATE>
 	static void Initialize(STATE &state) {
-		state.geom = nullptr;
-		state.context = GEOS_init_r();
+		state.context = nullptr;
+		state.geoms = nullptr;
+		state.blobs = nullptr;
+		state.blobs_size = 0;
+	}
+
+	template <class STATE>
+	static void AddBlob(STATE &state, const char *data, idx_t size) {
+		if (!state.blobs) {
+			state.blobs = new vector<string>();
+		}
+		state.blobs->emplace_back(data, size);
+		state.blobs_size += size;
+		if (state.blobs_size > UNION_BUFFER_SIZE) {
+			Flush(state);
+		}
+	}
+
+	// Union all buffered blobs and partial results into a single partial result
+	template <class STATE>
+	static void Flush(STATE &state) {
+		auto num_blobs = state.blobs ? state.blobs->size() : 0;
+		auto num_geoms = state.geoms ? state.geoms->size() : 0;
+		if (num_blobs == 0 && num_geoms <= 1) {
+			return;
+		}
+		if (!state.context) {
+			state.context = GEOS_init_r();
+		}
+		if (!state.geoms) {
+			state.geoms = new vector<GEOSGeometry *>();
+		}
+
+		auto &geoms = *state.geoms;
+		geoms.reserve(num_geoms + num_blobs);
+		for (idx_t i = 0; i < num_blobs; i++) {
+			auto &blob = (*state.blobs)[i];
+			geoms.push_back(DeserializeGEOSGeometry(string_t(blob.data(), blob.size()), state.context));
+		}
+		if (state.blobs) {
+			state.blobs->clear();
+			state.blobs_size = 0;
+		}
+
+		// The collection takes ownership of the geometries
+		auto collection = GEOSGeom_createCollection_r(state.context, GEOS_GEOMETRYCOLLECTION, geoms.data(),
+		                                              static_cast<unsigned int>(geoms.size()));
+		geoms.clear();
+		auto result = GEOSUnaryUnion_r(state.context, collection);
+		GEOSGeom_destroy_r(state.context, collection);
+		if (!result) {
+			throw InvalidInputException("Could not union geometries");
+		}
+		geoms.push_back(result);
 	}
 
 	template <class STATE, class OP>
 	static void Combine(const STATE &source, STATE &target, AggregateInputData &data) {
-		if (!source.geom) {
-			return;
+		// Merge the buffers, the actual union is deferred until the buffer is full or the state is finalized.
+		// The source may be combined again (e.g. in window functions), so copy rather than move its contents.
+		if (source.geoms && !source.geoms->empty()) {
+			if (!target.context) {
+				target.context = GEOS_init_r();
+			}
+			if (!target.geoms) {
+				target.geoms = new vector<GEOSGeometry *>();
+			}
+			for (auto &geom : *source.geoms) {
+				target.geoms->push_back(GEOSGeom_clone_r(target.context, geom));
+			}
 		}
-		if (!target.geom) {
-			target.geom = GEOSGeom_clone_r(target.context, source.geom);
-			return;
+		if (source.blobs) {
+			for (auto &blob : *source.blobs) {
+				AddBlob(target, blob.data(), blob.size());
+			}
 		}
-		auto curr = target.geom;
-		target.geom = GEOSUnion_r(target.context, curr, source.geom);
-		GEOSGeom_destroy_r(target.context, curr);
 	}
 
 	template <class INPUT_TYPE, class STATE, class OP>
 	static void Operation(STATE &state, const INPUT_TYPE &input, AggregateUnaryInput &) {
-		if (!state.geom) {
-			state.geom = DeserializeGEOSGeometry(input, state.context);
-		} else {
-			auto next = DeserializeGEOSGeometry(input, state.context);
-			auto curr = state.geom;
-			state.geom = GEOSUnion_r(state.context, curr, next);
-			GEOSGeom_destroy_r(state.context, next);
-			GEOSGeom_destroy_r(state.context, curr);
-		}
+		AddBlob(state, input.GetDataUnsafe(), input.GetSize());
 	}
 
 	template <class INPUT_TYPE, class STATE, class OP>
 	static void ConstantOperation(STATE &state, const INPUT_TYPE &input, AggregateUnaryInput &, idx_t count) {
-		// There is no point in doing anything else, union is idempotent
-		if (!state.geom) {
-			state.geom = DeserializeGEOSGeometry(input, state.context);
-		}
+		// Union is idempotent, so we only need to add the geometry once
+		AddBlob(state, input.GetDataUnsafe(), input.GetSize());
 	}
 
 	template <class T, class STATE>
 	static void Finalize(STATE &state, T &target, AggregateFinalizeData &finalize_data) {
-		if (!state.geom) {
+		Flush(state);
+		if (!state.geoms || state.geoms->empty()) {
 			finalize_data.ReturnNull();
 		} else {
-			target = SerializeGEOSGeometry(finalize_data.result, state.geom, state.context);
+			target = SerializeGEOSGeometry(finalize_data.result, state.geoms->front(), state.context);
 		}
 	}
 
 	template <class STATE>
 	static void Destroy(STATE &state, AggregateInputData &) {
-		if (state.geom) {
-			GEOSGeom_destroy_r(state.context, state.geom);
-			state.geom = nullptr;
+		if (state.geoms) {
+			for (auto &geom : *state.geoms) {
+				GEOSGeom_destroy_r(state.context, geom);
+			}
+			delete state.geoms;
+			state.geoms = nullptr;
+		}
+		if (state.blobs) {
+			delete state.blobs;
+			state.blobs = nullptr;
 		}
 		if (state.context) {
 			GEOS_finish_r(state.context);
@@ -178,14 +377,15 @@ void GeosAggregateFunctions::Register(DatabaseInstance &db) {
 
 	AggregateFunctionSet st_intersection_agg("st_intersection_agg");
 	st_intersection_agg.AddFunction(
-	    AggregateFunction::UnaryAggregateDestructor<GEOSAggState, string_t, string_t, IntersectionAggFunction>(
+	    AggregateFunction::UnaryAggregateDestructor<GEOSIntersectionAggState, string_t, string_t,
+	                                                IntersectionAggFunction>(
 	        core::GeoTypes::GEOMETRY(), core::GeoTypes::GEOMETRY()));
 
 	ExtensionUtil::RegisterFunction(db, st_intersection_agg);
 
 	AggregateFunctionSet st_union_agg("st_union_agg");
 	st_union_agg.AddFunction(
-	    AggregateFunction::UnaryAggregateDestructor<GEOSAggState, string_t, string_t, UnionAggFunction>(
+	    AggregateFunction::UnaryAggregateDestructor<GEOSUnionAggState, string_t, string_t, UnionAggFunction>(
 	        core::GeoTypes::GEOMETRY(), core::GeoTypes::GEOMETRY()));
 
 	ExtensionUtil::RegisterFunction(db, st_union_agg);
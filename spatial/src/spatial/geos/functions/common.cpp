@@ -7,7 +7,9 @@ namespace geos {
 
 using namespace spatial::core;
 
-GEOSFunctionLocalState::GEOSFunctionLocalState(ClientContext &context) : ctx(), factory(BufferAllocator::Get(context)) {
+GEOSFunctionLocalState::GEOSFunctionLocalState(ClientContext &context)
+    : ctx(), factory(BufferAllocator::Get(context)),
+      prepared_cache(ctx, PreparedGeometryCache::GetMemoryBudget(context)) {
 }
 
 unique_ptr<FunctionLocalState> GEOSFunctionLocalState::Init(ExpressionState &state, const BoundFunctionExpression &expr,
@@ -21,7 +21,8 @@ static void ContainsFunction(DataChunk &args, ExpressionState &state, Vector &re
 	auto &right = args.data[1];
 	auto count = args.size();
 	GEOSExecutor::ExecuteNonSymmetricPreparedBinary(lstate, left, right, count, result, GEOSContains_r,
-	                                                GEOSPreparedContains_r);
+	                                                GEOSPreparedContains_r, GEOSPreparedWithin_r,
+	                                                GEOSPrefilters::Contains);
 }
 
 void GEOSScalarFunctions::RegisterStContains(DatabaseInstance &db) {
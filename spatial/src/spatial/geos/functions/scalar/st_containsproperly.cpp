@@ -25,6 +25,10 @@ static void ExecuteContainsProperlyPrepared(GEOSFunctionLocalState &lstate, Vect
 		auto left_prepared = make_uniq_geos(ctx, GEOSPrepare_r(ctx, left_geom.get()));
 
 		UnaryExecutor::Execute<string_t, bool>(right, result, count, [&](string_t &right_blob) {
+			bool decided;
+			if (GEOSPrefilters::TryDecide(GEOSPrefilters::ContainsProperly, left_blob, right_blob, decided)) {
+				return decided;
+			}
 			auto right_geometry = lstate.ctx.Deserialize(right_blob);
 			auto ok = GEOSPreparedContainsProperly_r(ctx, left_prepared.get(), right_geometry.get());
 			return ok == 1;
@@ -33,9 +37,19 @@ static void ExecuteContainsProperlyPrepared(GEOSFunctionLocalState &lstate, Vect
 		// ContainsProperly only has a prepared version, so we just prepare the left one always
 		BinaryExecutor::Execute<string_t, string_t, bool>(
 		    left, right, result, count, [&](string_t &left_blob, string_t &right_blob) {
-			    auto left_geometry = lstate.ctx.Deserialize(left_blob);
+			    bool decided;
+			    if (GEOSPrefilters::TryDecide(GEOSPrefilters::ContainsProperly, left_blob, right_blob, decided)) {
+				    return decided;
+			    }
 			    auto right_geometry = lstate.ctx.Deserialize(right_blob);
 
+			    // Reuse the prepared geometry if the left side repeats across rows
+			    auto cached_prepared = lstate.prepared_cache.Get(left_blob);
+			    if (cached_prepared) {
+				    return GEOSPreparedContainsProperly_r(ctx, cached_prepared, right_geometry.get()) == 1;
+			    }
+
+			    auto left_geometry = lstate.ctx.Deserialize(left_blob);
 			    auto left_prepared = make_uniq_geos(ctx, GEOSPrepare_r(ctx, left_geometry.get()));
 
 			    auto ok = GEOSPreparedContainsProperly_r(ctx, left_prepared.get(), right_geometry.get());
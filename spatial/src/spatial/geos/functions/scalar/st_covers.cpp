@@ -21,7 +21,8 @@ static void CoversFunction(DataChunk &args, ExpressionState &state, Vector &resu
 	auto &right = args.data[1];
 	auto count = args.size();
 	GEOSExecutor::ExecuteNonSymmetricPreparedBinary(lstate, left, right, count, result, GEOSCovers_r,
-	                                                GEOSPreparedCovers_r);
+	                                                GEOSPreparedCovers_r, GEOSPreparedCoveredBy_r,
+	                                                GEOSPrefilters::Covers);
 }
 
 void GEOSScalarFunctions::RegisterStCovers(DatabaseInstance &db) {
@@ -21,7 +21,7 @@ static void CrossesFunction(DataChunk &args, ExpressionState &state, Vector &res
 	auto &right = args.data[1];
 	auto count = args.size();
 	GEOSExecutor::ExecuteSymmetricPreparedBinary(lstate, left, right, count, result, GEOSCrosses_r,
-	                                             GEOSPreparedCrosses_r);
+	                                             GEOSPreparedCrosses_r, GEOSPrefilters::BoundsIntersect);
 }
 
 void GEOSScalarFunctions::RegisterStCrosses(DatabaseInstance &db) {
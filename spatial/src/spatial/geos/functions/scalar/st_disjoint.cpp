@@ -21,7 +21,7 @@ static void DisjointFunction(DataChunk &args, ExpressionState &state, Vector &re
 	auto &right = args.data[1];
 	auto count = args.size();
 	GEOSExecutor::ExecuteSymmetricPreparedBinary(lstate, left, right, count, result, GEOSDisjoint_r,
-	                                             GEOSPreparedDisjoint_r);
+	                                             GEOSPreparedDisjoint_r, GEOSPrefilters::Disjoint);
 }
 
 void GEOSScalarFunctions::RegisterStDisjoint(DatabaseInstance &db) {
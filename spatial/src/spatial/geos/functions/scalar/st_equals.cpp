@@ -3,6 +3,7 @@
 #include "spatial/geos/functions/scalar.hpp"
 #include "spatial/geos/functions/common.hpp"
 #include "spatial/geos/geos_wrappers.hpp"
+#include "spatial/geos/geos_executor.hpp"
 
 #include "duckdb/parser/parsed_data/create_scalar_function_info.hpp"
 #include "duckdb/common/vector_operations/unary_executor.hpp"
@@ -19,6 +20,11 @@ static void EqualsFunction(DataChunk &args, ExpressionState &state, Vector &resu
 	auto &ctx = lstate.ctx.GetCtx();
 	BinaryExecutor::Execute<string_t, string_t, bool>(args.data[0], args.data[1], result, args.size(),
 	                                                  [&](string_t &left_blob, string_t &right_blob) {
+		                                                  bool decided;
+		                                                  if (GEOSPrefilters::TryDecide(GEOSPrefilters::Equals, left_blob,
+		                                                                                right_blob, decided)) {
+			                                                  return decided;
+		                                                  }
 		                                                  auto left = lstate.ctx.Deserialize(left_blob);
 		                                                  auto right = lstate.ctx.Deserialize(right_blob);
 		                                                  return GEOSEquals_r(ctx, left.get(), right.get());
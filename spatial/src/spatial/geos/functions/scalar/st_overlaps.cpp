@@ -21,7 +21,7 @@ static void OverlapsFunction(DataChunk &args, ExpressionState &state, Vector &re
 	auto &right = args.data[1];
 	auto count = args.size();
 	GEOSExecutor::ExecuteSymmetricPreparedBinary(lstate, left, right, count, result, GEOSOverlaps_r,
-	                                             GEOSPreparedOverlaps_r);
+	                                             GEOSPreparedOverlaps_r, GEOSPrefilters::BoundsIntersect);
 }
 
 void GEOSScalarFunctions::RegisterStOverlaps(DatabaseInstance &db) {
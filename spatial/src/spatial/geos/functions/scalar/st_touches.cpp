@@ -21,7 +21,7 @@ static void TouchesFunction(DataChunk &args, ExpressionState &state, Vector &res
 	auto &right = args.data[1];
 	auto count = args.size();
 	GEOSExecutor::ExecuteSymmetricPreparedBinary(lstate, left, right, count, result, GEOSTouches_r,
-	                                             GEOSPreparedTouches_r);
+	                                             GEOSPreparedTouches_r, GEOSPrefilters::Touches);
 }
 
 void GEOSScalarFunctions::RegisterStTouches(DatabaseInstance &db) {
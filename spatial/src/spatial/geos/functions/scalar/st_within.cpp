@@ -21,7 +21,8 @@ static void WithinFunction(DataChunk &args, ExpressionState &state, Vector &resu
 	auto &right = args.data[1];
 	auto count = args.size();
 	GEOSExecutor::ExecuteNonSymmetricPreparedBinary(lstate, left, right, count, result, GEOSWithin_r,
-	                                                GEOSPreparedWithin_r);
+	                                                GEOSPreparedWithin_r, GEOSPreparedContains_r,
+	                                                GEOSPrefilters::Within);
 }
 
 void GEOSScalarFunctions::RegisterStWithin(DatabaseInstance &db) {
@@ -0,0 +1,65 @@
+#include "duckdb/function/pragma_function.hpp"
+
+#include "spatial/common.hpp"
+#include "spatial/geos/functions/table.hpp"
+#include "spatial/geos/geos_prepared_cache.hpp"
+
+namespace spatial {
+
+namespace geos {
+
+//------------------------------------------------------------------------
+// Prepared Geometry Cache Statistics
+//------------------------------------------------------------------------
+// Counters of all prepared geometry caches that have been released so far,
+// i.e. of all queries that have finished executing.
+
+struct PreparedCacheStatsState : public GlobalTableFunctionState {
+	bool done = false;
+};
+
+static unique_ptr<FunctionData> PreparedCacheStatsBind(ClientContext &context, TableFunctionBindInput &input,
+                                                       vector<LogicalType> &return_types, vector<string> &names) {
+	return_types.emplace_back(LogicalType::UBIGINT);
+	return_types.emplace_back(LogicalType::UBIGINT);
+	return_types.emplace_back(LogicalType::UBIGINT);
+	names.emplace_back("hits");
+	names.emplace_back("misses");
+	names.emplace_back("evictions");
+	return nullptr;
+}
+
+static unique_ptr<GlobalTableFunctionState> PreparedCacheStatsInit(ClientContext &context,
+                                                                   TableFunctionInitInput &input) {
+	return make_uniq<PreparedCacheStatsState>();
+}
+
+static void PreparedCacheStatsExecute(ClientContext &context, TableFunctionInput &input, DataChunk &output) {
+	auto &state = input.global_state->Cast<PreparedCacheStatsState>();
+	if (state.done) {
+		return;
+	}
+	auto stats = PreparedGeometryCache::GetGlobalStats();
+	output.data[0].SetValue(0, Value::UBIGINT(stats.hits));
+	output.data[1].SetValue(0, Value::UBIGINT(stats.misses));
+	output.data[2].SetValue(0, Value::UBIGINT(stats.evictions));
+	output.SetCardinality(1);
+	state.done = true;
+}
+
+static string PreparedCacheStatsPragma(ClientContext &context, const FunctionParameters &parameters) {
+	return "SELECT * FROM spatial_prepared_cache_stats()";
+}
+
+void GeosTableFunctions::Register(DatabaseInstance &db) {
+	TableFunction func("spatial_prepared_cache_stats", {}, PreparedCacheStatsExecute, PreparedCacheStatsBind,
+	                   PreparedCacheStatsInit);
+	ExtensionUtil::RegisterFunction(db, func);
+
+	auto pragma = PragmaFunction::PragmaStatement("spatial_prepared_cache_stats", PreparedCacheStatsPragma);
+	ExtensionUtil::RegisterFunction(db, pragma);
+}
+
+} // namespace geos
+
+} // namespace spatial
@@ -0,0 +1,111 @@
+#include "spatial/common.hpp"
+#include "spatial/core/geometry/geometry.hpp"
+#include "spatial/geos/geos_prepared_cache.hpp"
+
+#include "duckdb/common/types/hash.hpp"
+#include "duckdb/parallel/task_scheduler.hpp"
+#include "duckdb/storage/buffer_manager.hpp"
+
+namespace spatial {
+
+namespace geos {
+
+using namespace spatial::core;
+
+// Prepared geometries keep the deserialized geometry and a spatial index around, estimate them as a multiple of
+// the serialized size.
+static constexpr idx_t PREPARED_SIZE_FACTOR = 4;
+// The share of the memory limit all caches together may use
+static constexpr idx_t MEMORY_LIMIT_FRACTION = 16;
+// Forget about geometries seen once after this many, to keep the candidate set bounded
+static constexpr idx_t MAX_CANDIDATES = 8192;
+
+static mutex global_stats_lock;
+static PreparedGeometryCacheStats global_stats;
+
+PreparedGeometryCache::PreparedGeometryCache(GeosContextWrapper &ctx, idx_t memory_budget)
+    : ctx(ctx), memory_budget(memory_budget) {
+}
+
+PreparedGeometryCache::~PreparedGeometryCache() {
+	lock_guard<mutex> guard(global_stats_lock);
+	global_stats.hits += stats.hits;
+	global_stats.misses += stats.misses;
+	global_stats.evictions += stats.evictions;
+}
+
+idx_t PreparedGeometryCache::GetMemoryBudget(ClientContext &context) {
+	auto max_memory = BufferManager::GetBufferManager(context).GetMaxMemory();
+	auto num_threads = MaxValue<idx_t>(TaskScheduler::GetScheduler(context).NumberOfThreads(), 1);
+	return max_memory / MEMORY_LIMIT_FRACTION / num_threads;
+}
+
+PreparedGeometryCacheStats PreparedGeometryCache::GetGlobalStats() {
+	lock_guard<mutex> guard(global_stats_lock);
+	return global_stats;
+}
+
+const GEOSPreparedGeometry *PreparedGeometryCache::Get(const string_t &blob) {
+	// Preparing points doesn't gain us anything
+	if (GeometryHeader::Get(blob).type == GeometryType::POINT) {
+		return nullptr;
+	}
+	auto size = blob.GetSize();
+	auto data = blob.GetDataUnsafe();
+	auto hash = Hash(data, size);
+
+	auto entry = index.find(hash);
+	if (entry != index.end()) {
+		auto &cached = *entry->second;
+		if (cached.blob.size() == size && memcmp(cached.blob.data(), data, size) == 0) {
+			stats.hits++;
+			entries.splice(entries.begin(), entries, entry->second);
+			return cached.prepared.get();
+		}
+		// Hash collision, replace the entry below
+		memory_usage -= cached.size;
+		entries.erase(entry->second);
+		index.erase(entry);
+	}
+	stats.misses++;
+
+	if (candidates.find(hash) == candidates.end()) {
+		// First time we see this geometry
+		if (candidates.size() >= MAX_CANDIDATES) {
+			candidates.clear();
+		}
+		candidates.insert(hash);
+		return nullptr;
+	}
+	candidates.erase(hash);
+
+	auto entry_size = size * PREPARED_SIZE_FACTOR;
+	if (entry_size > memory_budget) {
+		return nullptr;
+	}
+
+	auto geometry = ctx.Deserialize(blob);
+	auto prepared = make_uniq_geos(ctx.GetCtx(), GEOSPrepare_r(ctx.GetCtx(), geometry.get()));
+
+	entries.push_front(Entry {hash, string(data, size), std::move(geometry), std::move(prepared), entry_size});
+	index[hash] = entries.begin();
+	memory_usage += entry_size;
+	Evict();
+
+	return entries.front().prepared.get();
+}
+
+void PreparedGeometryCache::Evict() {
+	// Never evict the entry we just inserted
+	while (memory_usage > memory_budget && entries.size() > 1) {
+		auto &last = entries.back();
+		memory_usage -= last.size;
+		index.erase(last.hash);
+		entries.pop_back();
+		stats.evictions++;
+	}
+}
+
+} // namespace geos
+
+} // namespace spatial
@@ -12,9 +12,22 @@ using namespace core;
 //------------------------------------------------------------------------------
 // Deserialize
 //------------------------------------------------------------------------------
-// Note: We dont use GEOSCoordSeq_CopyFromBuffer here because we cant actually guarantee that the
-// double* is aligned to 8 bytes when duckdb loads the blob from storage, and GEOS only performs a
-// memcpy for 3d geometry. In the future this may change on our end though.
+// Vertex data is always 8-byte aligned relative to the start of the serialized blob, so when the blob itself is
+// aligned we can hand the coordinates to GEOS as a single buffer copy. We can't guarantee that the blob is aligned
+// when duckdb loads it from storage though, so in that case we first copy the vertices into an aligned buffer.
+static GEOSCoordSequence *DeserializeCoordSeq(Cursor &reader, uint32_t count, GEOSContextHandle_t ctx) {
+	auto ptr = reader.GetPtr();
+	auto byte_size = count * 2 * sizeof(double);
+	reader.Skip(byte_size);
+
+	if (reinterpret_cast<uintptr_t>(ptr) % alignof(double) == 0) {
+		return GEOSCoordSeq_copyFromBuffer_r(ctx, reinterpret_cast<const double *>(ptr), count, 0, 0);
+	}
+	auto staging = make_unsafe_uniq_array<double>(count * 2);
+	memcpy(staging.get(), ptr, byte_size);
+	return GEOSCoordSeq_copyFromBuffer_r(ctx, staging.get(), count, 0, 0);
+}
+
 static GEOSGeometry *DeserializeGeometry(Cursor &reader, GEOSContextHandle_t ctx);
 static GEOSGeometry *DeserializePoint(Cursor &reader, GEOSContextHandle_t ctx) {
 	reader.Skip(4); // skip type
@@ -22,14 +35,9 @@ static GEOSGeometry *DeserializePoint(Cursor &reader, GEOSContextHandle_t ctx) {
 	if (count == 0) {
 		return GEOSGeom_createEmptyPoint_r(ctx);
 	} else {
-		auto seq = GEOSCoordSeq_create_r(ctx, count, 2);
-		for (uint32_t i = 0; i < count; i++) {
-			auto x = reader.Read<double>();
-			auto y = reader.Read<double>();
-			GEOSCoordSeq_setX_r(ctx, seq, i, x);
-			GEOSCoordSeq_setY_r(ctx, seq, i, y);
-		}
-		return GEOSGeom_createPoint_r(ctx, seq);
+		auto x = reader.Read<double>();
+		auto y = reader.Read<double>();
+		return GEOSGeom_createPointFromXY_r(ctx, x, y);
 	}
 }
 
@@ -39,13 +47,7 @@ static GEOSGeometry *DeserializeLineString(Cursor &reader, GEOSContextHandle_t c
 	if (count == 0) {
 		return GEOSGeom_createEmptyLineString_r(ctx);
 	} else {
-		auto seq = GEOSCoordSeq_create_r(ctx, count, 2);
-		for (uint32_t i = 0; i < count; i++) {
-			auto x = reader.Read<double>();
-			auto y = reader.Read<double>();
-			GEOSCoordSeq_setX_r(ctx, seq, i, x);
-			GEOSCoordSeq_setY_r(ctx, seq, i, y);
-		}
+		auto seq = DeserializeCoordSeq(reader, count, ctx);
 		return GEOSGeom_createLineString_r(ctx, seq);
 	}
 }
@@ -56,24 +58,23 @@ static GEOSGeometry *DeserializePolygon(Cursor &reader, GEOSContextHandle_t ctx)
 	if (num_rings == 0) {
 		return GEOSGeom_createEmptyPolygon_r(ctx);
 	} else {
-		// TODO: This doesnt handle the offset properly
 		auto rings = new GEOSGeometry *[num_rings];
-		auto data_ptr = reader.GetPtr() + sizeof(uint32_t) * num_rings + ((num_rings % 2) * sizeof(uint32_t));
+
+		// The ring counts come first, followed by padding if the number of rings is odd, and then the vertex data
+		auto counts = new uint32_t[num_rings];
+		for (uint32_t i = 0; i < num_rings; i++) {
+			counts[i] = reader.Read<uint32_t>();
+		}
+		if (num_rings % 2 == 1) {
+			reader.Skip(4); // skip padding
+		}
+
 		for (uint32_t i = 0; i < num_rings; i++) {
-			auto count = reader.Read<uint32_t>();
-			auto seq = GEOSCoordSeq_create_r(ctx, count, 2);
-			for (uint32_t j = 0; j < count; j++) {
-				auto x = Load<double>(data_ptr);
-				data_ptr += sizeof(double);
-				auto y = Load<double>(data_ptr);
-				data_ptr += sizeof(double);
-				GEOSCoordSeq_setX_r(ctx, seq, j, x);
-				GEOSCoordSeq_setY_r(ctx, seq, j, y);
-			}
+			auto seq = DeserializeCoordSeq(reader, counts[i], ctx);
 			rings[i] = GEOSGeom_createLinearRing_r(ctx, seq);
 		}
-		reader.SetPtr(data_ptr);
 		auto poly = GEOSGeom_createPolygon_r(ctx, rings[0], rings + 1, num_rings - 1);
+		delete[] counts;
 		delete[] rings;
 		return poly;
 	}
@@ -297,6 +298,22 @@ static uint32_t GetSerializedSize(const GEOSGeometry *geom, const GEOSContextHan
 }
 static void SerializeGeometry(Cursor &writer, const GEOSGeometry *geom, const GEOSContextHandle_t ctx);
 
+// Copy the coordinates out of GEOS in one go, staging them in an aligned buffer if the target isn't aligned.
+static void SerializeCoordSeq(Cursor &writer, const GEOSCoordSequence *seq, uint32_t count,
+                              const GEOSContextHandle_t ctx) {
+	auto ptr = writer.GetPtr();
+	auto byte_size = count * 2 * sizeof(double);
+	writer.Skip(byte_size);
+
+	if (reinterpret_cast<uintptr_t>(ptr) % alignof(double) == 0) {
+		GEOSCoordSeq_copyToBuffer_r(ctx, seq, reinterpret_cast<double *>(ptr), 0, 0);
+		return;
+	}
+	auto staging = make_unsafe_uniq_array<double>(count * 2);
+	GEOSCoordSeq_copyToBuffer_r(ctx, seq, staging.get(), 0, 0);
+	memcpy(ptr, staging.get(), byte_size);
+}
+
 static void SerializePoint(Cursor &writer, const GEOSGeometry *geom, const GEOSContextHandle_t ctx) {
 	writer.Write<uint32_t>((uint32_t)GeometryType::POINT);
 
@@ -307,8 +324,7 @@ static void SerializePoint(Cursor &writer, const GEOSGeometry *geom, const GEOSC
 	writer.Write<uint32_t>(1);
 	auto seq = GEOSGeom_getCoordSeq_r(ctx, geom);
 	double x, y;
-	GEOSCoordSeq_getX_r(ctx, seq, 0, &x);
-	GEOSCoordSeq_getY_r(ctx, seq, 0, &y);
+	GEOSCoordSeq_getXY_r(ctx, seq, 0, &x, &y);
 	writer.Write<double>(x);
 	writer.Write<double>(y);
 }
@@ -319,17 +335,10 @@ static void SerializeLineString(Cursor &writer, const GEOSGeometry *geom, const
 	uint32_t count;
 	GEOSCoordSeq_getSize_r(ctx, seq, &count);
 	writer.Write<uint32_t>(count);
-	for (uint32_t i = 0; i < count; i++) {
-		double x, y;
-		GEOSCoordSeq_getX_r(ctx, seq, i, &x);
-		GEOSCoordSeq_getY_r(ctx, seq, i, &y);
-		writer.Write<double>(x);
-		writer.Write<double>(y);
-	}
+	SerializeCoordSeq(writer, seq, count, ctx);
 }
 
 static void SerializePolygon(Cursor &writer, const GEOSGeometry *geom, const GEOSContextHandle_t ctx) {
-	// TODO: check this
 	writer.Write<uint32_t>((uint32_t)GeometryType::POLYGON);
 
 	// Write number of rings
@@ -367,13 +376,7 @@ static void SerializePolygon(Cursor &writer, const GEOSGeometry *geom, const GEO
 
 	// Second pass, write data for each ring
 	// Start with shell
-	for (uint32_t i = 0; i < shell_count; i++) {
-		double x, y;
-		GEOSCoordSeq_getX_r(ctx, shell_seq, i, &x);
-		GEOSCoordSeq_getY_r(ctx, shell_seq, i, &y);
-		writer.Write<double>(x);
-		writer.Write<double>(y);
-	}
+	SerializeCoordSeq(writer, shell_seq, shell_count, ctx);
 
 	// Then write each hole
 	for (uint32_t i = 0; i < num_holes; i++) {
@@ -381,13 +384,7 @@ static void SerializePolygon(Cursor &writer, const GEOSGeometry *geom, const GEO
 		auto ring_seq = GEOSGeom_getCoordSeq_r(ctx, ring);
 		uint32_t ring_count;
 		GEOSCoordSeq_getSize_r(ctx, ring_seq, &ring_count);
-		for (uint32_t j = 0; j < ring_count; j++) {
-			double x, y;
-			GEOSCoordSeq_getX_r(ctx, ring_seq, j, &x);
-			GEOSCoordSeq_getY_r(ctx, ring_seq, j, &y);
-			writer.Write<double>(x);
-			writer.Write<double>(y);
-		}
+		SerializeCoordSeq(writer, ring_seq, ring_count, ctx);
 	}
 }
 
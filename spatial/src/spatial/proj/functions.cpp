@@ -4,6 +4,8 @@
 #include "duckdb/parser/parsed_data/create_view_info.hpp"
 #include "duckdb/execution/expression_executor.hpp"
 #include "duckdb/planner/expression/bound_function_expression.hpp"
+#include "duckdb/common/mutex.hpp"
+#include "duckdb/common/unordered_map.hpp"
 
 #include "spatial/common.hpp"
 #include "spatial/core/types.hpp"
@@ -17,19 +19,119 @@ namespace spatial {
 
 namespace proj {
 
+struct ProjCRSDelete {
+	void operator()(PJ *crs) {
+		proj_destroy(crs);
+	}
+};
+
+using ProjCRS = unique_ptr<PJ, ProjCRSDelete>;
+
+//------------------------------------------------------------------------------
+// Transformation Cache
+//------------------------------------------------------------------------------
+// Creating a transformation requires a lot of lookups in proj.db and can take milliseconds, while cloning an existing
+// one is cheap. PJ objects can not be shared between threads though, so we keep a process-wide cache of all
+// transformations created so far, which threads clone into their own context.
+class ProjCRSCache {
+public:
+	static ProjCRSCache &Get() {
+		static ProjCRSCache instance;
+		return instance;
+	}
+
+	// Returns a clone of the cached transformation bound to the given context, or nullptr if not cached
+	ProjCRS TryClone(PJ_CONTEXT *ctx, const string &key) {
+		lock_guard<mutex> guard(lock);
+		auto entry = entries.find(key);
+		if (entry == entries.end()) {
+			return nullptr;
+		}
+		return ProjCRS(proj_clone(ctx, entry->second.get()));
+	}
+
+	void Insert(const string &key, PJ *crs) {
+		lock_guard<mutex> guard(lock);
+		if (entries.size() >= MAX_ENTRIES || entries.find(key) != entries.end()) {
+			return;
+		}
+		auto clone = proj_clone(cache_ctx, crs);
+		if (clone) {
+			entries.emplace(key, ProjCRS(clone));
+		}
+	}
+
+private:
+	static constexpr idx_t MAX_ENTRIES = 4096;
+
+	ProjCRSCache() : cache_ctx(ProjModule::GetThreadProjContext()) {
+	}
+
+	~ProjCRSCache() {
+		entries.clear();
+		proj_context_destroy(cache_ctx);
+	}
+
+	mutex lock;
+	PJ_CONTEXT *cache_ctx;
+	unordered_map<string, ProjCRS> entries;
+};
+
 struct ProjFunctionLocalState : public FunctionLocalState {
 
 	PJ_CONTEXT *proj_ctx;
 	core::GeometryFactory factory;
+	// Transformations used by this thread, keyed on (from, to, always_xy)
+	unordered_map<string, ProjCRS> crs_cache;
 
 	ProjFunctionLocalState(ClientContext &context)
 	    : proj_ctx(ProjModule::GetThreadProjContext()), factory(BufferAllocator::Get(context)) {
 	}
 
 	~ProjFunctionLocalState() override {
+		// The transformations have to be destroyed before the context they belong to
+		crs_cache.clear();
 		proj_context_destroy(proj_ctx);
 	}
 
+	// Get the transformation between two CRSs. The returned pointer is only valid until the next call.
+	PJ *GetCRS(const string &from_str, const string &to_str, bool conventional_gis_order) {
+		string key = from_str;
+		key += '\0';
+		key += to_str;
+		key += conventional_gis_order ? '1' : '0';
+
+		auto entry = crs_cache.find(key);
+		if (entry != crs_cache.end()) {
+			return entry->second.get();
+		}
+
+		auto &global_cache = ProjCRSCache::Get();
+		auto crs = global_cache.TryClone(proj_ctx, key);
+		if (!crs) {
+			crs = ProjCRS(proj_create_crs_to_crs(proj_ctx, from_str.c_str(), to_str.c_str(), nullptr));
+			if (!crs) {
+				throw InvalidInputException("Could not create projection: " + from_str + " -> " + to_str);
+			}
+
+			if (conventional_gis_order) {
+				auto normalized_crs = proj_normalize_for_visualization(proj_ctx, crs.get());
+				if (normalized_crs) {
+					crs = ProjCRS(normalized_crs);
+				}
+				// otherwise fall back to the original CRS
+			}
+			global_cache.Insert(key, crs.get());
+		}
+
+		if (crs_cache.size() >= MAX_CACHED_CRS) {
+			crs_cache.clear();
+		}
+		auto result = crs.get();
+		crs_cache.emplace(std::move(key), std::move(crs));
+		return result;
+	}
+
 	static unique_ptr<FunctionLocalState> Init(ExpressionState &state, const BoundFunctionExpression &expr,
 	                                           FunctionData *bind_data) {
 		auto result = make_uniq<ProjFunctionLocalState>(state.GetContext());
@@ -41,6 +143,9 @@ struct ProjFunctionLocalState : public FunctionLocalState {
 		local_state.factory.allocator.Reset();
 		return local_state;
 	}
+
+private:
+	static constexpr idx_t MAX_CACHED_CRS = 256;
 };
 
 struct TransformFunctionData : FunctionData {
@@ -94,23 +199,10 @@ static void Box2DTransformFunction(DataChunk &args, ExpressionState &state, Vect
 	if (proj_from.GetVectorType() == VectorType::CONSTANT_VECTOR &&
 	    proj_to.GetVectorType() == VectorType::CONSTANT_VECTOR && !ConstantVector::IsNull(proj_from) &&
 	    !ConstantVector::IsNull(proj_to)) {
-		// Special case: both projections are constant, so we can create the projection once and reuse it
+		// Special case: both projections are constant, so we can look up the projection once and reuse it
 		auto from_str = ConstantVector::GetData<PROJ_TYPE>(proj_from)[0].val.GetString();
 		auto to_str = ConstantVector::GetData<PROJ_TYPE>(proj_to)[0].val.GetString();
-
-		auto crs = proj_create_crs_to_crs(proj_ctx, from_str.c_str(), to_str.c_str(), nullptr);
-		if (!crs) {
-			throw InvalidInputException("Could not create projection: " + from_str + " -> " + to_str);
-		}
-
-		if (info.conventional_gis_order) {
-			auto normalized_crs = proj_normalize_for_visualization(proj_ctx, crs);
-			if (normalized_crs) {
-				proj_destroy(crs);
-				crs = normalized_crs;
-			}
-			// otherwise fall back to the original CRS
-		}
+		auto crs = local_state.GetCRS(from_str, to_str, info.conventional_gis_order);
 
 		GenericExecutor::ExecuteUnary<BOX_TYPE, BOX_TYPE>(box, result, count, [&](BOX_TYPE box_in) {
 			BOX_TYPE box_out;
@@ -119,36 +211,18 @@ static void Box2DTransformFunction(DataChunk &args, ExpressionState &state, Vect
 			                  &box_out.a_val, &box_out.b_val, &box_out.c_val, &box_out.d_val, densify_pts);
 			return box_out;
 		});
-
-		proj_destroy(crs);
 	} else {
 		GenericExecutor::ExecuteTernary<BOX_TYPE, PROJ_TYPE, PROJ_TYPE, BOX_TYPE>(
 		    box, proj_from, proj_to, result, count, [&](BOX_TYPE box_in, PROJ_TYPE proj_from, PROJ_TYPE proj_to) {
 			    auto from_str = proj_from.val.GetString();
 			    auto to_str = proj_to.val.GetString();
-
-			    auto crs = proj_create_crs_to_crs(nullptr, from_str.c_str(), to_str.c_str(), nullptr);
-			    if (!crs) {
-				    throw InvalidInputException("Could not create projection: " + from_str + " -> " + to_str);
-			    }
-
-			    if (info.conventional_gis_order) {
-				    auto normalized_crs = proj_normalize_for_visualization(proj_ctx, crs);
-				    if (normalized_crs) {
-					    proj_destroy(crs);
-					    crs = normalized_crs;
-				    }
-				    // otherwise fall back to the original CRS
-			    }
+			    auto crs = local_state.GetCRS(from_str, to_str, info.conventional_gis_order);
 
 			    // TODO: this may be interesting to use, but at that point we can only return a BOX_TYPE
 			    int densify_pts = 0;
 			    BOX_TYPE box_out;
 			    proj_trans_bounds(proj_ctx, crs, PJ_FWD, box_in.a_val, box_in.b_val, box_in.c_val, box_in.d_val,
 			                      &box_out.a_val, &box_out.b_val, &box_out.c_val, &box_out.d_val, densify_pts);
-
-			    proj_destroy(crs);
-
 			    return box_out;
 		    });
 	}
@@ -164,100 +238,77 @@ static void Point2DTransformFunction(DataChunk &args, ExpressionState &state, Ve
 	auto &proj_to = args.data[2];
 
 	auto &local_state = ProjFunctionLocalState::ResetAndGet(state);
-	auto &proj_ctx = local_state.proj_ctx;
 	auto &func_expr = state.expr.Cast<BoundFunctionExpression>();
 	auto &info = func_expr.bind_info->Cast<TransformFunctionData>();
 
 	if (proj_from.GetVectorType() == VectorType::CONSTANT_VECTOR &&
 	    proj_to.GetVectorType() == VectorType::CONSTANT_VECTOR && !ConstantVector::IsNull(proj_from) &&
 	    !ConstantVector::IsNull(proj_to)) {
-		// Special case: both projections are constant, so we can create the projection once and reuse it
+		// Special case: both projections are constant, so we can look up the projection once and
+		// transform all the points in a single call
 		auto from_str = ConstantVector::GetData<PROJ_TYPE>(proj_from)[0].val.GetString();
 		auto to_str = ConstantVector::GetData<PROJ_TYPE>(proj_to)[0].val.GetString();
-
-		auto crs = proj_create_crs_to_crs(proj_ctx, from_str.c_str(), to_str.c_str(), nullptr);
-		if (!crs) {
-			throw InvalidInputException("Could not create projection: " + from_str + " -> " + to_str);
-		}
-
-		if (info.conventional_gis_order) {
-			auto normalized_crs = proj_normalize_for_visualization(proj_ctx, crs);
-			if (normalized_crs) {
-				proj_destroy(crs);
-				crs = normalized_crs;
-			}
-			// otherwise fall back to the original CRS
-		}
-
-		GenericExecutor::ExecuteUnary<POINT_TYPE, POINT_TYPE>(point, result, count, [&](POINT_TYPE point_in) {
-			POINT_TYPE point_out;
-			auto transformed = proj_trans(crs, PJ_FWD, proj_coord(point_in.a_val, point_in.b_val, 0, 0)).xy;
-			point_out.a_val = transformed.x;
-			point_out.b_val = transformed.y;
-			return point_out;
-		});
-		proj_destroy(crs);
-
+		auto crs = local_state.GetCRS(from_str, to_str, info.conventional_gis_order);
+
+		point.Flatten(count);
+		auto &point_children = StructVector::GetEntries(point);
+		auto &result_children = StructVector::GetEntries(result);
+		auto x_data = FlatVector::GetData<double>(*result_children[0]);
+		auto y_data = FlatVector::GetData<double>(*result_children[1]);
+		memcpy(x_data, FlatVector::GetData<double>(*point_children[0]), count * sizeof(double));
+		memcpy(y_data, FlatVector::GetData<double>(*point_children[1]), count * sizeof(double));
+		FlatVector::SetValidity(result, FlatVector::Validity(point));
+
+		proj_trans_generic(crs, PJ_FWD, x_data, sizeof(double), count, y_data, sizeof(double), count, nullptr, 0, 0,
+		                   nullptr, 0, 0);
 	} else {
 		GenericExecutor::ExecuteTernary<POINT_TYPE, PROJ_TYPE, PROJ_TYPE, POINT_TYPE>(
 		    point, proj_from, proj_to, result, count, [&](POINT_TYPE point_in, PROJ_TYPE proj_from, PROJ_TYPE proj_to) {
 			    auto from_str = proj_from.val.GetString();
 			    auto to_str = proj_to.val.GetString();
-
-			    auto crs = proj_create_crs_to_crs(proj_ctx, from_str.c_str(), to_str.c_str(), nullptr);
-			    if (!crs) {
-				    throw InvalidInputException("Could not create projection: " + from_str + " -> " + to_str);
-			    }
-
-			    if (info.conventional_gis_order) {
-				    auto normalized_crs = proj_normalize_for_visualization(proj_ctx, crs);
-				    if (normalized_crs) {
-					    proj_destroy(crs);
-					    crs = normalized_crs;
-				    }
-				    // otherwise fall back to the original CRS
-			    }
+			    auto crs = local_state.GetCRS(from_str, to_str, info.conventional_gis_order);
 
 			    POINT_TYPE point_out;
 			    auto transformed = proj_trans(crs, PJ_FWD, proj_coord(point_in.a_val, point_in.b_val, 0, 0)).xy;
 			    point_out.a_val = transformed.x;
 			    point_out.b_val = transformed.y;
-
-			    proj_destroy(crs);
-
 			    return point_out;
 		    });
 	}
 }
 
-static void TransformGeometry(PJ *crs, core::Point &point) {
-	if (point.IsEmpty()) {
+// Transform all vertices in a single call, writing the results in place
+static void TransformGeometry(PJ *crs, const core::VertexVector &vertices) {
+	auto count = vertices.Count();
+	if (count == 0) {
 		return;
 	}
-	auto vertex = point.GetVertex();
-	auto transformed = proj_trans(crs, PJ_FWD, proj_coord(vertex.x, vertex.y, 0, 0)).xy;
-	point.Vertices().Set(0, core::Vertex(transformed.x, transformed.y));
+	if (reinterpret_cast<uintptr_t>(vertices.data) % alignof(double) != 0) {
+		// Can't hand out unaligned pointers, transform one vertex at a time instead
+		for (uint32_t i = 0; i < count; i++) {
+			auto vert = vertices.Get(i);
+			auto transformed = proj_trans(crs, PJ_FWD, proj_coord(vert.x, vert.y, 0, 0)).xy;
+			vertices.Set(i, core::Vertex(transformed.x, transformed.y));
+		}
+		return;
+	}
+	auto x_data = reinterpret_cast<double *>(vertices.data);
+	auto y_data = x_data + 1;
+	proj_trans_generic(crs, PJ_FWD, x_data, sizeof(core::Vertex), count, y_data, sizeof(core::Vertex), count, nullptr,
+	                   0, 0, nullptr, 0, 0);
 }
 
-static void TransformGeometry(PJ *crs, core::LineString &line) {
-
-	for (uint32_t i = 0; i < line.Vertices().Count(); i++) {
-		auto vert = line.Vertices().Get(i);
-		auto transformed = proj_trans(crs, PJ_FWD, proj_coord(vert.x, vert.y, 0, 0)).xy;
+static void TransformGeometry(PJ *crs, core::Point &point) {
+	TransformGeometry(crs, point.Vertices());
+}
 
-		core::Vertex new_vert(transformed.x, transformed.y);
-		line.Vertices().Set(i, new_vert);
-	}
+static void TransformGeometry(PJ *crs, core::LineString &line) {
+	TransformGeometry(crs, line.Vertices());
 }
 
 static void TransformGeometry(PJ *crs, core::Polygon &poly) {
 	for (auto &ring : poly.Rings()) {
-		for (uint32_t i = 0; i < ring.Count(); i++) {
-			auto vert = ring.Get(i);
-			auto transformed = proj_trans(crs, PJ_FWD, proj_coord(vert.x, vert.y, 0, 0)).xy;
-			core::Vertex new_vert(transformed.x, transformed.y);
-			ring.Set(i, new_vert);
-		}
+		TransformGeometry(crs, ring);
 	}
 }
 
@@ -315,14 +366,6 @@ static void TransformGeometry(PJ *crs, core::Geometry &geom) {
 	}
 }
 
-struct ProjCRSDelete {
-	void operator()(PJ *crs) {
-		proj_destroy(crs);
-	}
-};
-
-using ProjCRS = unique_ptr<PJ, ProjCRSDelete>;
-
 static void GeometryTransformFunction(DataChunk &args, ExpressionState &state, Vector &result) {
 	auto count = args.size();
 	auto &geom_vec = args.data[0];
@@ -334,63 +377,36 @@ static void GeometryTransformFunction(DataChunk &args, ExpressionState &state, V
 	auto &func_expr = state.expr.Cast<BoundFunctionExpression>();
 	auto &info = func_expr.bind_info->Cast<TransformFunctionData>();
 
-	auto &proj_ctx = local_state.proj_ctx;
 	auto &factory = local_state.factory;
 
 	if (proj_from_vec.GetVectorType() == VectorType::CONSTANT_VECTOR &&
 	    proj_to_vec.GetVectorType() == VectorType::CONSTANT_VECTOR && !ConstantVector::IsNull(proj_from_vec) &&
 	    !ConstantVector::IsNull(proj_to_vec)) {
 		// Special case: both projections are constant (very common)
-		// we can create the projection once and reuse it for all geometries
-
-		// TODO: In the future we can cache the projections in the state instead.
-
+		// we can look up the projection once and reuse it for all geometries
 		auto from_str = ConstantVector::GetData<string_t>(proj_from_vec)[0].GetString();
 		auto to_str = ConstantVector::GetData<string_t>(proj_to_vec)[0].GetString();
-		auto crs = ProjCRS(proj_create_crs_to_crs(proj_ctx, from_str.c_str(), to_str.c_str(), nullptr));
-		if (!crs.get()) {
-			throw InvalidInputException("Could not create projection: " + from_str + " -> " + to_str);
-		}
-
-		if (info.conventional_gis_order) {
-			auto normalized_crs = proj_normalize_for_visualization(proj_ctx, crs.get());
-			if (normalized_crs) {
-				crs = ProjCRS(normalized_crs);
-			}
-			// otherwise fall back to the original CRS
-		}
+		auto crs = local_state.GetCRS(from_str, to_str, info.conventional_gis_order);
 
 		UnaryExecutor::Execute<string_t, string_t>(geom_vec, result, count, [&](string_t input_geom) {
 			auto geom = factory.Deserialize(input_geom);
 			auto copy = factory.CopyGeometry(geom);
-			TransformGeometry(crs.get(), copy);
+			TransformGeometry(crs, copy);
 			return factory.Serialize(result, copy);
 		});
 	} else {
 		// General case: projections are not constant
-		// we need to create a projection for each geometry
+		// we need to look up the projection for each geometry, but they are cached by the local state
 		TernaryExecutor::Execute<string_t, string_t, string_t, string_t>(
 		    geom_vec, proj_from_vec, proj_to_vec, result, count,
 		    [&](string_t input_geom, string_t proj_from, string_t proj_to) {
 			    auto from_str = proj_from.GetString();
 			    auto to_str = proj_to.GetString();
-			    auto crs = ProjCRS(proj_create_crs_to_crs(proj_ctx, from_str.c_str(), to_str.c_str(), nullptr));
-
-			    if (!crs.get()) {
-				    throw InvalidInputException("Could not create projection: " + from_str + " -> " + to_str);
-			    }
-
-			    if (info.conventional_gis_order) {
-				    auto normalized_crs = proj_normalize_for_visualization(proj_ctx, crs.get());
-				    if (normalized_crs) {
-					    crs = ProjCRS(normalized_crs);
-				    }
-				    // otherwise fall back to the original CRS
-			    }
+			    auto crs = local_state.GetCRS(from_str, to_str, info.conventional_gis_order);
 
 			    auto geom = factory.Deserialize(input_geom);
 			    auto copy = factory.CopyGeometry(geom);
-			    TransformGeometry(crs.get(), copy);
+			    TransformGeometry(crs, copy);
 			    return factory.Serialize(result, copy);
 		    });
 	}